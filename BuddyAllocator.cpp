@@ -0,0 +1,117 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include <iterator>
+#include "BuddyAllocator.h"
+
+int BuddyAllocator::orderFor(unsigned long long size) {
+    if (size <= 1) {
+        return 0;
+    }
+    //ceil(log2(size))
+    return ORDERS - __builtin_clzll(size - 1);
+}
+
+unsigned long long BuddyAllocator::blockSize(unsigned long long size) {
+    int order = orderFor(size);
+    return order >= ORDERS ? ~0ULL : 1ULL << order;
+}
+
+void BuddyAllocator::addBlock(unsigned long long address, int order) {
+    freeBlocks_[order].insert(address);
+    nonEmptyOrders_ |= (1ULL << order);
+    ++count_;
+    histogram_.add(1ULL << order);
+}
+
+void BuddyAllocator::removeBlock(unsigned long long address, int order) {
+    freeBlocks_[order].erase(address);
+    if (freeBlocks_[order].empty()) {
+        nonEmptyOrders_ &= ~(1ULL << order);
+    }
+    --count_;
+    histogram_.remove(1ULL << order);
+}
+
+void BuddyAllocator::reset(unsigned long long amountOfRAM) {
+    freeBlocks_.assign(ORDERS, BlockSet{BlockSet::allocator_type{&pool_}});
+    nonEmptyOrders_ = 0;
+    roots_.clear();
+    allocatedOrder_.clear();
+    count_ = 0;
+    histogram_.clear();
+
+    //carve RAM into aligned power-of-two roots, largest first
+    unsigned long long address = 0;
+    while (address < amountOfRAM) {
+        auto remaining = amountOfRAM - address;
+        int order = ORDERS - 1 - __builtin_clzll(remaining);
+        if (address != 0) {
+            order = std::min(order, __builtin_ctzll(address));
+        }
+        roots_[address] = order;
+        addBlock(address, order);
+        address += (1ULL << order);
+    }
+}
+
+bool BuddyAllocator::allocate(unsigned long long size, unsigned long long& address) {
+    int order = orderFor(size);
+    if (order >= ORDERS) {
+        return false;
+    }
+    auto usable = nonEmptyOrders_ & (~0ULL << order);
+    if (usable == 0) {
+        return false;
+    }
+    //smallest free block that is big enough
+    int blockOrder = __builtin_ctzll(usable);
+    auto block = *freeBlocks_[blockOrder].begin();
+    removeBlock(block, blockOrder);
+
+    //split down, upper halves stay free
+    while (blockOrder > order) {
+        --blockOrder;
+        addBlock(block + (1ULL << blockOrder), blockOrder);
+    }
+    allocatedOrder_[block] = order;
+    address = block;
+    return true;
+}
+
+void BuddyAllocator::release(unsigned long long address, unsigned long long /*size*/) {
+    auto allocated = allocatedOrder_.find(address);
+    if (allocated == allocatedOrder_.end()) {
+        return;
+    }
+    int order = allocated->second;
+    allocatedOrder_.erase(allocated);
+
+    //never merge past the root block this address lives in
+    int rootOrder = std::prev(roots_.upper_bound(address))->second;
+    while (order < rootOrder) {
+        auto buddy = address ^ (1ULL << order);
+        if (freeBlocks_[order].count(buddy) == 0) {
+            break;
+        }
+        removeBlock(buddy, order);
+        address = std::min(address, buddy);
+        ++order;
+    }
+    addBlock(address, order);
+}
+
+unsigned long long BuddyAllocator::largestHole() const {
+    if (nonEmptyOrders_ == 0) {
+        return 0;
+    }
+    return 1ULL << (ORDERS - 1 - __builtin_clzll(nonEmptyOrders_));
+}
+
+size_t BuddyAllocator::holeCount() const {
+    return count_;
+}
+
+const HoleHistogram& BuddyAllocator::histogram() const {
+    return histogram_;
+}
@@ -0,0 +1,47 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "NodePool.h"
+#include "HoleHistogram.h"
+
+//Binary buddy allocator
+//RAM is split into the largest aligned power-of-two root blocks that fit,
+//each root is then split/merged with its buddy as usual
+//A bitmask of non-empty orders finds the smallest usable block with one bit scan
+class BuddyAllocator {
+    public:
+        void reset(unsigned long long amountOfRAM);
+
+        //block of 2^ceil(log2(size)) bytes, lowest address among equal blocks
+        bool allocate(unsigned long long size, unsigned long long& address);
+        void release(unsigned long long address, unsigned long long size);
+        //bytes allocate(size) takes
+        static unsigned long long blockSize(unsigned long long size);
+
+        unsigned long long largestHole() const;
+        size_t holeCount() const;
+        const HoleHistogram& histogram() const;     //free blocks, bucket k = order k
+
+    private:
+        static constexpr int ORDERS {64};
+        using BlockSet = std::set<unsigned long long, std::less<unsigned long long>, PoolAllocator<unsigned long long>>;
+        using OrderMap = std::unordered_map<unsigned long long, int, std::hash<unsigned long long>, std::equal_to<unsigned long long>,
+                                            PoolAllocator<std::pair<const unsigned long long, int>>>;
+
+        //set/hash nodes are recycled through the pool -> split/merge doesn't malloc
+        NodePool pool_;
+        std::vector<BlockSet> freeBlocks_;                          //order -> free block addresses
+        unsigned long long nonEmptyOrders_ {0};                     //bit k set if freeBlocks_[k] non-empty
+        std::map<unsigned long long, int> roots_;                   //root block address -> order
+        OrderMap allocatedOrder_ {OrderMap::allocator_type{&pool_}}; //block address -> order
+        size_t count_ {0};
+        HoleHistogram histogram_;
+
+        static int orderFor(unsigned long long size);
+        void addBlock(unsigned long long address, int order);
+        void removeBlock(unsigned long long address, int order);
+};
@@ -0,0 +1,234 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include <functional>
+#include "ConcurrentSimOS.h"
+
+ConcurrentSimOS::ConcurrentSimOS(int numberOfDisks, unsigned long long amountOfRAM, unsigned long long sizeOfOS,
+                                 const SimOSConfig& config) :
+    sim_{numberOfDisks, amountOfRAM, sizeOfOS, config},
+    pending_{nullptr},
+    stop_{false},
+    sleeping_{false},
+    current_{nullptr},
+    epoch_{0},
+    overflow_{OVERFLOW_EPOCH},
+    applied_{0},
+    version_{0} {
+
+    publish();
+    owner_ = std::thread([this] { run(); });
+}
+
+ConcurrentSimOS::~ConcurrentSimOS() {
+    stop_.store(true);
+    {
+        std::lock_guard<std::mutex> lock (sleepLock_);
+        wakeUp_.notify_one();
+    }
+    owner_.join();
+
+    //no readers can be left once the owner is destroyed
+    for (auto& entry : retired_) {
+        delete entry.snapshot;
+    }
+    delete current_.load();
+}
+
+void ConcurrentSimOS::push(Node* node) {
+    //Treiber push, the owner takes the whole stack at once so there is no ABA
+    node->next = pending_.load(std::memory_order_relaxed);
+    //seq_cst: the push must be ordered before the sleeping_ load, or the owner can park right after
+    //its own check of pending_ and the wake up is lost (store buffer pattern against run())
+    while (!pending_.compare_exchange_weak(node->next, node, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    }
+    if (sleeping_.load()) {
+        std::lock_guard<std::mutex> lock (sleepLock_);
+        wakeUp_.notify_one();
+    }
+}
+
+void ConcurrentSimOS::post(const SimCommand& command, std::string fileName) {
+    push(new Node{command, std::move(fileName)});
+}
+
+std::future<SimResult> ConcurrentSimOS::call(const SimCommand& command, std::string fileName) {
+    auto reply = new std::promise<SimResult>;
+    auto result = reply->get_future();
+    push(new Node{command, std::move(fileName), reply});
+    return result;
+}
+
+void ConcurrentSimOS::sync() {
+    auto reply = new std::promise<SimResult>;
+    auto done = reply->get_future();
+    push(new Node{SimCommand{}, {}, reply, true});
+    done.wait();
+}
+
+void ConcurrentSimOS::run() {
+    while (true) {
+        Node* list = pending_.exchange(nullptr, std::memory_order_acquire);
+        if (list) {
+            apply(list);
+            continue;
+        }
+        if (stop_.load()) {
+            //pending_ was empty after stop_ was set -> nothing left to apply
+            return;
+        }
+        //park, re-checking under the lock so a push between the exchange and the wait is not missed
+        std::unique_lock<std::mutex> lock (sleepLock_);
+        sleeping_.store(true);
+        wakeUp_.wait(lock, [this] { return pending_.load() != nullptr || stop_.load(); });
+        sleeping_.store(false);
+    }
+}
+
+void ConcurrentSimOS::apply(Node* list) {
+    //stack -> submission order
+    nodes_.clear();
+    for (Node* node = list; node != nullptr; node = node->next) {
+        nodes_.push_back(node);
+    }
+    std::reverse(nodes_.begin(), nodes_.end());
+
+    batch_.clear();
+    fileNames_.clear();
+    for (Node* node : nodes_) {
+        if (node->marker) {
+            continue;
+        }
+        batch_.push_back(node->command);
+        if (node->command.type == CommandType::DISK_READ) {
+            batch_.back().fileId = static_cast<int>(fileNames_.size());
+            fileNames_.push_back(std::move(node->fileName));
+        }
+    }
+    results_.assign(batch_.size(), 0);
+    sim_.ApplyBatch(batch_.data(), batch_.size(), results_.data(), fileNames_);
+    applied_ += batch_.size();
+    ++version_;
+    publish();
+
+    //answer only after the snapshot is out, so a caller that waited also sees its effect in read()
+    size_t index = 0;
+    for (Node* node : nodes_) {
+        SimResult result = node->marker ? 0 : results_[index++];
+        if (node->reply) {
+            node->reply->set_value(result);
+            delete node->reply;
+        }
+        delete node;
+    }
+}
+
+void ConcurrentSimOS::publish() {
+    auto snapshot = new SimSnapshot;
+    snapshot->version = version_;
+    snapshot->applied = applied_;
+    int cores = sim_.GetCoreCount();
+    snapshot->cpus.reserve(cores);
+    snapshot->readyQueues.reserve(cores);
+    for (int core = 0; core < cores; ++core) {
+        snapshot->cpus.push_back(sim_.GetCPU(core));
+        auto ready = sim_.ViewReadyQueue(core);
+        snapshot->readyQueues.emplace_back(ready.begin(), ready.end());
+    }
+    auto memory = sim_.ViewMemory();
+    snapshot->memory.assign(memory.begin(), memory.end());
+    int disks = sim_.GetDiskCount();
+    for (int disk = 0; disk < disks; ++disk) {
+        snapshot->disks.push_back(sim_.GetDisk(disk));
+        auto queue = sim_.ViewDiskQueue(disk);
+        snapshot->diskQueues.emplace_back(queue.begin(), queue.end());
+    }
+
+    SimSnapshot* old = current_.exchange(snapshot);
+    if (old) {
+        //readers that announced an epoch <= this one may still hold old
+        retired_.push_back({old, epoch_.fetch_add(1)});
+    }
+    reclaim();
+}
+
+void ConcurrentSimOS::reclaim() {
+    unsigned long long oldest = IDLE;
+    for (auto& slot : readers_) {
+        oldest = std::min(oldest, slot.epoch.load());
+    }
+    auto overflow = overflow_.load() & OVERFLOW_EPOCH;
+    if (overflow != OVERFLOW_EPOCH) {
+        oldest = std::min(oldest, overflow);
+    }
+    auto kept = std::remove_if(retired_.begin(), retired_.end(), [oldest](const Retired& entry) {
+        if (entry.epoch < oldest) {
+            delete entry.snapshot;
+            return true;
+        }
+        return false;
+    });
+    retired_.erase(kept, retired_.end());
+}
+
+int ConcurrentSimOS::acquireSlot() {
+    //start at a per thread spot so threads rarely collide on a slot
+    size_t start = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    for (int i = 0; i < READER_SLOTS; ++i) {
+        int slot = static_cast<int>((start + i) % READER_SLOTS);
+        bool expected = false;
+        if (!readers_[slot].taken.load(std::memory_order_relaxed) &&
+            readers_[slot].taken.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+    //more than READER_SLOTS guards alive at once -> share the overflow word
+    return OVERFLOW_SLOT;
+}
+
+//a CAS loop only retries when another guard changed the word -> lock free, never waits for a release
+//guards in the overflow pin the oldest epoch among them until the last one leaves
+void ConcurrentSimOS::joinOverflow(unsigned long long epoch) {
+    epoch = std::min(epoch, OVERFLOW_EPOCH - 1);
+    auto word = overflow_.load();
+    unsigned long long joined;
+    do {
+        joined = ((word >> OVERFLOW_SHIFT) + 1) << OVERFLOW_SHIFT | std::min(word & OVERFLOW_EPOCH, epoch);
+    } while (!overflow_.compare_exchange_weak(word, joined));
+}
+
+void ConcurrentSimOS::leaveOverflow() {
+    auto word = overflow_.load();
+    unsigned long long left;
+    do {
+        auto count = (word >> OVERFLOW_SHIFT) - 1;
+        left = count << OVERFLOW_SHIFT | (count == 0 ? OVERFLOW_EPOCH : word & OVERFLOW_EPOCH);
+    } while (!overflow_.compare_exchange_weak(word, left));
+}
+
+ConcurrentSimOS::ReadGuard ConcurrentSimOS::read() {
+    return ReadGuard(*this);
+}
+
+ConcurrentSimOS::ReadGuard::ReadGuard(ConcurrentSimOS& owner) :
+    owner_{owner},
+    slot_{owner.acquireSlot()},
+    snapshot_{nullptr} {
+
+    //announce first, then load: a snapshot retired at an epoch >= ours stays alive
+    if (slot_ == OVERFLOW_SLOT) {
+        owner_.joinOverflow(owner_.epoch_.load());
+    } else {
+        owner_.readers_[slot_].epoch.store(owner_.epoch_.load());
+    }
+    snapshot_ = owner_.current_.load();
+}
+
+ConcurrentSimOS::ReadGuard::~ReadGuard() {
+    if (slot_ == OVERFLOW_SLOT) {
+        owner_.leaveOverflow();
+        return;
+    }
+    owner_.readers_[slot_].epoch.store(IDLE);
+    owner_.readers_[slot_].taken.store(false, std::memory_order_release);
+}
@@ -0,0 +1,125 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SimCommand.h"
+#include "SimOS.h"
+
+//Read-only copy of the observable SimOS state, published after every applied batch
+struct SimSnapshot {
+    unsigned long long version{0};          //batches applied before it was taken
+    unsigned long long applied{0};          //commands applied before it was taken
+    std::vector<int> cpus;                  //per core, NO_PROCESS when idle
+    std::vector<std::vector<int>> readyQueues;
+    MemoryUse memory;
+    std::vector<FileReadRequest> disks;
+    std::vector<std::vector<FileReadRequest>> diskQueues;
+};
+
+//Thread-safe front end: any thread submits, one owner thread applies
+//
+//Producers push onto a lock-free intrusive stack (one CAS); the owner takes the whole stack with one
+//exchange, reverses it back to submission order and feeds it to SimOS::ApplyBatch
+//Commands from one producer are applied in the order it submitted them
+//
+//Snapshots are read through an epoch scheme: a reader announces the epoch it started in, then loads
+//the current snapshot; a replaced snapshot is freed only once every announced epoch is newer,
+//so readers never lock and never make the owner wait
+//Guards past READER_SLOTS share one overflow word (count + oldest epoch) updated by CAS -> still no waiting
+class ConcurrentSimOS {
+    public:
+        ConcurrentSimOS(int numberOfDisks, unsigned long long amountOfRAM, unsigned long long sizeOfOS,
+                        const SimOSConfig& config = SimOSConfig{});
+        //applies everything already submitted, then stops the owner thread
+        ~ConcurrentSimOS();
+        ConcurrentSimOS(const ConcurrentSimOS&) = delete;
+        ConcurrentSimOS& operator=(const ConcurrentSimOS&) = delete;
+
+        //fire and forget, fileName is only used by DISK_READ (fileId is ignored)
+        void post(const SimCommand& command, std::string fileName = {});
+        //same, the future gets the command's SimResult
+        std::future<SimResult> call(const SimCommand& command, std::string fileName = {});
+        //returns once everything this thread submitted before is applied and visible in read()
+        void sync();
+
+        //pins the snapshot that is current on construction, never blocks (any number of guards)
+        class ReadGuard {
+            public:
+                ~ReadGuard();
+                ReadGuard(const ReadGuard&) = delete;
+                ReadGuard& operator=(const ReadGuard&) = delete;
+                const SimSnapshot& operator*() const { return *snapshot_; }
+                const SimSnapshot* operator->() const { return snapshot_; }
+            private:
+                friend class ConcurrentSimOS;
+                ReadGuard(ConcurrentSimOS& owner);
+                ConcurrentSimOS& owner_;
+                int slot_;
+                const SimSnapshot* snapshot_;
+        };
+        ReadGuard read();
+
+    private:
+        struct Node {
+            SimCommand command;
+            std::string fileName;
+            std::promise<SimResult>* reply{nullptr};
+            bool marker{false};                     //sync(), not applied
+            Node* next{nullptr};
+        };
+        struct Retired {
+            SimSnapshot* snapshot;
+            unsigned long long epoch;
+        };
+        //one cache line per reader slot so readers don't share lines
+        struct alignas(64) ReaderSlot {
+            std::atomic<bool> taken{false};
+            std::atomic<unsigned long long> epoch{IDLE};
+        };
+        static constexpr unsigned long long IDLE {~0ULL};
+        static constexpr int READER_SLOTS {64};
+        static constexpr int OVERFLOW_SLOT {-1};
+        static constexpr int OVERFLOW_SHIFT {48};
+        static constexpr unsigned long long OVERFLOW_EPOCH {(1ULL << OVERFLOW_SHIFT) - 1};     //epoch bits, all set = none
+
+        SimOS sim_;
+        std::atomic<Node*> pending_;
+        std::atomic<bool> stop_;
+
+        //owner thread parking, producers only touch the mutex when it is asleep
+        std::atomic<bool> sleeping_;
+        std::mutex sleepLock_;
+        std::condition_variable wakeUp_;
+
+        std::atomic<SimSnapshot*> current_;
+        std::atomic<unsigned long long> epoch_;
+        std::array<ReaderSlot, READER_SLOTS> readers_;
+        std::atomic<unsigned long long> overflow_;  //guard count << OVERFLOW_SHIFT | oldest epoch among them
+        std::vector<Retired> retired_;              //owner thread only
+
+        //owner thread only, reused between batches
+        std::vector<SimCommand> batch_;
+        std::vector<SimResult> results_;
+        std::vector<std::string> fileNames_;
+        std::vector<Node*> nodes_;
+        unsigned long long applied_;
+        unsigned long long version_;
+
+        std::thread owner_;
+
+        void push(Node* node);
+        void run();
+        void apply(Node* list);
+        void publish();
+        void reclaim();
+        int acquireSlot();                          //OVERFLOW_SLOT when every slot is taken
+        void joinOverflow(unsigned long long epoch);
+        void leaveOverflow();
+};
@@ -0,0 +1,384 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include <iterator>
+#include "DiskQueue.h"
+
+DiskQueue::DiskQueue() :
+    index_{PoolAllocator<Key>(&pool_)},
+    extents_{PoolAllocator<Key>(&pool_)} {}
+
+bool DiskQueue::indexed() const {
+    return policy_ != DiskPolicyType::FIFO;
+}
+
+void DiskQueue::configure(DiskPolicyType policy, int deadline, bool merge) {
+    policy_ = policy;
+    deadline_ = deadline > 0 ? deadline : 1;
+    merge_ = merge;
+    //(re)build the lookups over whatever is already waiting
+    index_.clear();
+    extents_.clear();
+    byFile_.clear();
+    for (int node = head_; node != NIL; node = nodes_[node].next) {
+        track(node);
+    }
+}
+
+DiskPolicyType DiskQueue::policy() const {
+    return policy_;
+}
+
+void DiskQueue::track(int node) {
+    auto& current = nodes_[node];
+    if (indexed()) {
+        current.key = index_.insert(Key{current.start, current.arrival, node}).first;
+    }
+    if (merge_ && current.mergeable) {
+        if (current.end > current.start) {
+            current.extent = extents_.insert(Key{current.start, current.arrival, node}).first;
+        }
+        byFile_[std::get<0>(current.entry).fileName] = node;
+    }
+}
+
+void DiskQueue::untrack(int node) {
+    auto& current = nodes_[node];
+    if (indexed()) {
+        index_.erase(current.key);
+    }
+    if (merge_ && current.mergeable) {
+        if (current.end > current.start) {
+            extents_.erase(current.extent);
+        }
+        auto found = byFile_.find(std::get<0>(current.entry).fileName);
+        if (found != byFile_.end() && found->second == node) {
+            byFile_.erase(found);
+        }
+    }
+}
+
+//queued job a request can ride on: same file, or a block range touching / overlapping it
+int DiskQueue::findJob(const FileReadRequest& request) {
+    auto sameFile = byFile_.find(request.fileName);
+    if (sameFile != byFile_.end()) {
+        return sameFile->second;
+    }
+    if (request.size == 0 || extents_.empty()) {
+        return NIL;
+    }
+    auto after = extents_.upper_bound(Key{request.block, ~0ULL, NIL});
+    if (after != extents_.begin() && nodes_[std::prev(after)->node].end >= request.block) {
+        return std::prev(after)->node;
+    }
+    if (after != extents_.end() && after->block <= request.block + request.size) {
+        return after->node;
+    }
+    return NIL;
+}
+
+int DiskQueue::newMember(const Entry& entry) {
+    int member;
+    if (!freeMembers_.empty()) {
+        member = freeMembers_.back();
+        freeMembers_.pop_back();
+    } else {
+        member = static_cast<int>(members_.size());
+        members_.emplace_back();
+    }
+    members_[member].entry = entry;
+    std::get<1>(entry)->diskMember_ = member;
+    return member;
+}
+
+void DiskQueue::append(MemberList& list, int member) {
+    members_[member].prev = list.tail;
+    members_[member].next = NIL;
+    if (list.tail != NIL) {
+        members_[list.tail].next = member;
+    } else {
+        list.head = member;
+    }
+    list.tail = member;
+    ++list.size;
+}
+
+void DiskQueue::remove(MemberList& list, int member) {
+    auto& current = members_[member];
+    if (current.prev != NIL) {
+        members_[current.prev].next = current.next;
+    } else {
+        list.head = current.next;
+    }
+    if (current.next != NIL) {
+        members_[current.next].prev = current.prev;
+    } else {
+        list.tail = current.prev;
+    }
+    --list.size;
+    std::get<1>(current.entry)->diskMember_ = -1;
+    current.entry = Entry{};
+    freeMembers_.push_back(member);
+}
+
+void DiskQueue::join(int node, const Entry& entry) {
+    const auto& request = std::get<0>(entry);
+    append(nodes_[node].followers, newMember(entry));
+    auto& job = nodes_[node];
+    std::get<1>(entry)->diskNode_ = node;
+    ++count_;
+    ++stats_.merged;
+
+    //grow the job's block range (re-keyed, the start may move)
+    if (request.size > 0) {
+        auto start = job.end > job.start ? std::min(job.start, request.block) : request.block;
+        auto end = job.end > job.start ? std::max(job.end, request.block + request.size) : request.block + request.size;
+        if (start != job.start || end != job.end) {
+            untrack(node);
+            job.start = start;
+            job.end = end;
+            track(node);
+        }
+    }
+}
+
+void DiskQueue::push(const Entry& entry, bool mergeable) {
+    const auto& request = std::get<0>(entry);
+    if (merge_ && mergeable) {
+        int job = findJob(request);
+        if (job != NIL) {
+            join(job, entry);
+            return;
+        }
+    }
+
+    int node;
+    if (!freeNodes_.empty()) {
+        node = freeNodes_.back();
+        freeNodes_.pop_back();
+    } else {
+        node = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    auto& fresh = nodes_[node];
+    fresh.entry = entry;
+    fresh.prev = tail_;
+    fresh.next = NIL;
+    fresh.arrival = arrivals_++;
+    fresh.dispatchedBefore = stats_.dispatched;
+    fresh.start = request.block;
+    fresh.end = request.block + request.size;
+    fresh.mergeable = mergeable;
+    fresh.followers = MemberList{};
+
+    //append at tail
+    if (tail_ != NIL) {
+        nodes_[tail_].next = node;
+    } else {
+        head_ = node;
+    }
+    tail_ = node;
+    track(node);
+    std::get<1>(entry)->diskNode_ = node;
+    ++count_;
+}
+
+void DiskQueue::unlink(int node) {
+    untrack(node);
+    auto& current = nodes_[node];
+    if (current.prev != NIL) {
+        nodes_[current.prev].next = current.next;
+    } else {
+        head_ = current.next;
+    }
+    if (current.next != NIL) {
+        nodes_[current.next].prev = current.prev;
+    } else {
+        tail_ = current.prev;
+    }
+    std::get<1>(current.entry)->diskNode_ = -1;
+    current.entry = Entry{};
+    freeNodes_.push_back(node);
+    --count_;
+}
+
+DiskQueue::Index::iterator DiskQueue::firstAtOrAbove(unsigned long long block) {
+    return index_.lower_bound(Key{block, 0, NIL});
+}
+
+//earliest arrival at the highest block <= block, end() if none
+DiskQueue::Index::iterator DiskQueue::firstOfLastAtOrBelow(unsigned long long block) {
+    auto above = index_.upper_bound(Key{block, ~0ULL, NIL});
+    if (above == index_.begin()) {
+        return index_.end();
+    }
+    return index_.lower_bound(Key{std::prev(above)->block, 0, NIL});
+}
+
+int DiskQueue::select() {
+    switch (policy_) {
+        case DiskPolicyType::FIFO:
+            return head_;
+        case DiskPolicyType::SSTF: {
+            auto up = firstAtOrAbove(position_);
+            auto down = firstOfLastAtOrBelow(position_);
+            if (up == index_.end()) {
+                return down->node;
+            }
+            if (down == index_.end()) {
+                return up->node;
+            }
+            //equal distance -> the one that came first
+            auto upDistance = up->block - position_;
+            auto downDistance = position_ - down->block;
+            if (upDistance != downDistance) {
+                return upDistance < downDistance ? up->node : down->node;
+            }
+            return up->arrival < down->arrival ? up->node : down->node;
+        }
+        case DiskPolicyType::SCAN: {
+            for (int turns = 0; turns < 2; ++turns) {
+                auto next = upwards_ ? firstAtOrAbove(position_) : firstOfLastAtOrBelow(position_);
+                if (next != index_.end()) {
+                    return next->node;
+                }
+                upwards_ = !upwards_;
+            }
+            return head_;
+        }
+        case DiskPolicyType::DEADLINE:
+            //the oldest request is at the FIFO head
+            if (stats_.dispatched - nodes_[head_].dispatchedBefore >= static_cast<unsigned long long>(deadline_)) {
+                ++stats_.expired;
+                return head_;
+            }
+            [[fallthrough]];
+        case DiskPolicyType::C_LOOK: {
+            auto next = firstAtOrAbove(position_);
+            return next != index_.end() ? next->node : index_.begin()->node;
+        }
+    }
+    return head_;
+}
+
+DiskQueue::Entry DiskQueue::take() {
+    int node = select();
+    auto& job = nodes_[node];
+    Entry entry = job.entry;
+    //the head covers the whole job
+    FileReadRequest extent {0, "", job.start, job.end - job.start};
+    //the followers list moves over whole, no longer queued
+    for (int member = job.followers.head; member != NIL; member = members_[member].next) {
+        std::get<1>(members_[member].entry)->diskNode_ = -1;
+    }
+    if (job.followers.head != NIL) {
+        if (riders_.tail != NIL) {
+            members_[riders_.tail].next = job.followers.head;
+            members_[job.followers.head].prev = riders_.tail;
+        } else {
+            riders_.head = job.followers.head;
+        }
+        riders_.tail = job.followers.tail;
+        riders_.size += job.followers.size;
+    }
+    count_ -= job.followers.size;
+    job.followers = MemberList{};
+    unlink(node);
+    dispatch(extent);
+    return entry;
+}
+
+void DiskQueue::dispatch(const FileReadRequest& request) {
+    stats_.seekDistance += request.block > position_ ? request.block - position_ : position_ - request.block;
+    ++stats_.dispatched;
+    position_ = request.block + request.size;
+}
+
+void DiskQueue::erase(Process* ptr) {
+    if (!contains(ptr)) {
+        return;
+    }
+    int node = ptr->diskNode_;
+    auto& job = nodes_[node];
+    if (ptr->diskMember_ >= 0) {
+        //a follower, the job stays
+        remove(job.followers, ptr->diskMember_);
+        ptr->diskNode_ = -1;
+        --count_;
+    } else if (job.followers.head == NIL) {
+        unlink(node);
+    } else {
+        //first follower leads the job now, its block range stays
+        untrack(node);
+        job.entry = members_[job.followers.head].entry;
+        remove(job.followers, job.followers.head);
+        ptr->diskNode_ = -1;
+        --count_;
+        track(node);
+    }
+}
+
+bool DiskQueue::contains(const Process* ptr) const {
+    if (ptr == nullptr || ptr->diskNode_ < 0 || static_cast<size_t>(ptr->diskNode_) >= nodes_.size()) {
+        return false;
+    }
+    if (ptr->diskMember_ >= 0) {
+        return static_cast<size_t>(ptr->diskMember_) < members_.size() && std::get<1>(members_[ptr->diskMember_].entry) == ptr;
+    }
+    return std::get<1>(nodes_[ptr->diskNode_].entry) == ptr;
+}
+
+bool DiskQueue::empty() const {
+    return count_ == 0;
+}
+
+size_t DiskQueue::size() const {
+    return count_;
+}
+
+const DiskStats& DiskQueue::stats() const {
+    return stats_;
+}
+
+void DiskQueue::takeRiders(std::vector<Entry>& out) {
+    out.clear();
+    while (riders_.head != NIL) {
+        out.push_back(members_[riders_.head].entry);
+        remove(riders_, riders_.head);
+    }
+}
+
+bool DiskQueue::promoteRider(Entry& leader) {
+    if (riders_.head == NIL) {
+        return false;
+    }
+    leader = members_[riders_.head].entry;
+    remove(riders_, riders_.head);
+    return true;
+}
+
+//riders are no longer queued (diskNode_ -1) but keep their slot
+bool DiskQueue::dropRider(Process* ptr) {
+    int member = ptr->diskMember_;
+    if (ptr->diskNode_ >= 0 || member < 0 || std::get<1>(members_[member].entry) != ptr) {
+        return false;
+    }
+    remove(riders_, member);
+    return true;
+}
+
+DiskQueue::const_iterator DiskQueue::begin() const {
+    return const_iterator(this, head_);
+}
+
+DiskQueue::const_iterator DiskQueue::end() const {
+    return const_iterator(this, NIL);
+}
+
+DiskQueue::const_iterator DiskQueue::ridersBegin() const {
+    return const_iterator(this, NIL, riders_.head);
+}
+
+size_t DiskQueue::riderCount() const {
+    return riders_.size;
+}
@@ -0,0 +1,181 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "NodePool.h"
+#include "Process.h"
+
+//FOR DISK
+struct FileReadRequest {
+    int  PID{0};
+    std::string fileName{""};
+    unsigned long long block{0};        //first block / cylinder, 0 when not modelled
+    unsigned long long size{0};         //blocks read, the head ends up at block + size
+};
+
+//Which waiting request a disk serves next
+enum class DiskPolicyType {
+    FIFO,           //default, arrival order
+    SSTF,           //closest block to the head
+    SCAN,           //elevator: keep the direction while there is work ahead, then turn
+    C_LOOK,         //upwards only, wrap to the lowest block
+    DEADLINE        //C_LOOK, but a request passed over deadline times is served first
+};
+
+struct DiskSettings {
+    DiskPolicyType policy{DiskPolicyType::FIFO};
+    std::vector<DiskPolicyType> perDisk;    //policy of disk i when given, else policy
+    int deadline{16};                       //DEADLINE: dispatches a request may wait
+    bool merge{false};                      //coalesce queued reads of the same file / adjacent blocks
+};
+
+struct DiskStats {
+    unsigned long long dispatched{0};       //physical jobs started
+    unsigned long long seekDistance{0};     //sum of |block - head| over dispatches
+    unsigned long long expired{0};          //DEADLINE dispatches forced by an expired request
+    unsigned long long merged{0};           //requests that joined a queued job instead of queueing
+};
+
+//Waiting disk requests: a FIFO doubly linked list over a node pool, plus an index ordered by
+//(block, arrival) for the seek-aware policies, so picking the next request is O(log n)
+//Each queued Process remembers its node (diskNode_) so dropping it is O(1) (O(log n) indexed)
+//A process waits on at most one disk at a time, so one node index per process is enough
+//The disk head, sweep direction and seek counters live here too
+//
+//With merging on, a node is one physical job: the first request (leader) plus the followers that
+//read the same file or a touching block range. When the job is taken its followers become riders
+//of the request in service and wake with it. Followers and riders are linked lists over a second
+//pool, each process remembers its slot there too (diskMember_) -> dropping one is O(1) as well
+//Swap traffic is pushed unmergeable: its "swap" name and slot blocks say nothing about the data
+class DiskQueue {
+    public:
+        using Entry = std::tuple<FileReadRequest, Process*>;
+
+        DiskQueue();
+        DiskQueue(const DiskQueue&) = delete;
+        DiskQueue& operator=(const DiskQueue&) = delete;
+
+        void configure(DiskPolicyType policy, int deadline, bool merge = false);
+        DiskPolicyType policy() const;
+        void push(const Entry& entry, bool mergeable = true);
+        //remove and return the leader of the job the policy serves next (queue must not be empty)
+        //its followers move to riders()
+        Entry take();
+        //a job starts service (taken or sent straight to an idle disk) -> move the head
+        void dispatch(const FileReadRequest& request);
+        void erase(Process* ptr);
+        bool contains(const Process* ptr) const;
+        bool empty() const;
+        size_t size() const;                    //requests, followers included
+        const DiskStats& stats() const;
+
+        //requests served by the job in service besides its leader
+        //move the riders out when the job completes (out is cleared first)
+        void takeRiders(std::vector<Entry>& out);
+        //the leader in service went away -> first rider leads the job, false if there is none
+        bool promoteRider(Entry& leader);
+        bool dropRider(Process* ptr);
+
+        //walk in arrival order of jobs (not service order, which depends on the head),
+        //each leader followed by its followers
+        class const_iterator {
+            public:
+                const_iterator(const DiskQueue* queue, int node, int follower = -1) : queue_{queue}, node_{node}, follower_{follower} {}
+                const Entry& operator*() const {
+                    return follower_ < 0 ? queue_->nodes_[node_].entry : queue_->members_[follower_].entry;
+                }
+                const Entry* operator->() const { return &**this; }
+                const_iterator& operator++() {
+                    follower_ = follower_ < 0 ? queue_->nodes_[node_].followers.head : queue_->members_[follower_].next;
+                    if (follower_ < 0 && node_ >= 0) {
+                        node_ = queue_->nodes_[node_].next;
+                    }
+                    return *this;
+                }
+                bool operator==(const const_iterator& other) const { return node_ == other.node_ && follower_ == other.follower_; }
+                bool operator!=(const const_iterator& other) const { return !(*this == other); }
+            private:
+                const DiskQueue* queue_;
+                int node_;
+                int follower_;
+        };
+        const_iterator begin() const;
+        const_iterator end() const;
+        //riders of the job in service in arrival order, ends at end()
+        const_iterator ridersBegin() const;
+        size_t riderCount() const;
+
+    private:
+        static constexpr int NIL {-1};
+        struct Key {
+            unsigned long long block;
+            unsigned long long arrival;
+            int node;
+            bool operator<(const Key& other) const {
+                return block != other.block ? block < other.block : arrival < other.arrival;
+            }
+        };
+        using Index = std::set<Key, std::less<Key>, PoolAllocator<Key>>;
+        //merging: a follower of a queued job or a rider of the one in service
+        struct Member {
+            Entry entry;
+            int prev;
+            int next;
+        };
+        struct MemberList {
+            int head {NIL};
+            int tail {NIL};
+            size_t size {0};
+        };
+        struct Node {
+            Entry entry;
+            int prev;
+            int next;
+            unsigned long long arrival;
+            unsigned long long dispatchedBefore;   //stats_.dispatched when it was queued
+            Index::iterator key;
+            //merging: the job's block range and the requests riding on it
+            unsigned long long start;
+            unsigned long long end;
+            Index::iterator extent;
+            bool mergeable;
+            MemberList followers;
+        };
+        std::vector<Node> nodes_;
+        std::vector<int> freeNodes_;
+        std::vector<Member> members_;
+        std::vector<int> freeMembers_;
+        int head_ {NIL};
+        int tail_ {NIL};
+        size_t count_ {0};
+        unsigned long long arrivals_ {0};
+
+        DiskPolicyType policy_ {DiskPolicyType::FIFO};
+        int deadline_ {16};
+        bool merge_ {false};
+        unsigned long long position_ {0};          //disk head block
+        bool upwards_ {true};
+        DiskStats stats_;
+        NodePool pool_;
+        Index index_;                               //empty under FIFO
+        Index extents_;                             //merging: jobs with a block range, by start
+        std::unordered_map<std::string, int> byFile_;  //merging: leader file name -> job
+        MemberList riders_;
+
+        bool indexed() const;
+        int select();
+        Index::iterator firstAtOrAbove(unsigned long long block);
+        Index::iterator firstOfLastAtOrBelow(unsigned long long block);
+        int findJob(const FileReadRequest& request);
+        void join(int node, const Entry& entry);
+        void track(int node);
+        void untrack(int node);
+        void unlink(int node);
+        int newMember(const Entry& entry);
+        void append(MemberList& list, int member);
+        void remove(MemberList& list, int member);     //and frees the slot
+};
@@ -0,0 +1,241 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include <utility>
+#include "EventEngine.h"
+
+EventEngine::EventEngine(int numberOfDisks, unsigned long long amountOfRAM, unsigned long long sizeOfOS, 
+                         std::vector<DiskModel> diskModels, std::uint64_t seed, const SimOSConfig& config) :
+    sim_{numberOfDisks, amountOfRAM, sizeOfOS, config},
+    userRAM_{amountOfRAM > sizeOfOS ? amountOfRAM - sizeOfOS : 0},
+    diskModels_{std::move(diskModels)},
+    random_{seed},
+    sequence_{0},
+    now_{0},
+    firstArrival_{std::numeric_limits<double>::infinity()},
+    nextPID_{2},
+    cpuPID_(sim_.GetCoreCount(), NO_PROCESS),
+    cpuSince_(sim_.GetCoreCount(), 0),
+    cpuStamp_(sim_.GetCoreCount(), 0),
+    diskPID_(numberOfDisks, 0),
+    diskRead_(numberOfDisks, false),
+    diskSince_(numberOfDisks, 0),
+    diskStamp_(numberOfDisks, 0),
+    cpuBusy_{0},
+    diskBusy_(numberOfDisks, 0),
+    completed_{0},
+    rejected_{0},
+    turnaroundSum_{0},
+    maxTurnaround_{0},
+    waitingSum_{0} {
+
+    //disks without a model serve in one unit of time
+    diskModels_.resize(numberOfDisks);
+}
+
+double EventEngine::now() const {
+    return now_;
+}
+
+const SimOS& EventEngine::sim() const {
+    return sim_;
+}
+
+void EventEngine::submit(const Job& job) {
+    double arrival = std::max(job.arrival, now_);
+    firstArrival_ = std::min(firstArrival_, arrival);
+    jobs_.push_back(job);
+    jobs_.back().arrival = arrival;
+    schedule(arrival, EventType::ARRIVAL, static_cast<int>(jobs_.size()) - 1, 0);
+}
+
+void EventEngine::schedule(double time, EventType type, int target, std::uint64_t stamp) {
+    calendar_.push_back(Event{time, sequence_++, type, target, stamp});
+    std::push_heap(calendar_.begin(), calendar_.end(), Later{});
+}
+
+double EventEngine::serviceTime(int diskNumber) {
+    const DiskModel& model = diskModels_[diskNumber];
+    switch (model.type) {
+        case ServiceModel::UNIFORM:
+            return model.a + (model.b - model.a) * random_.unit();
+        case ServiceModel::EXPONENTIAL:
+            return random_.exponential(model.a);
+        default:
+            return model.a;
+    }
+}
+
+EngineReport EventEngine::run(double until) {
+    while (!calendar_.empty() && calendar_.front().time <= until) {
+        std::pop_heap(calendar_.begin(), calendar_.end(), Later{});
+        Event event = calendar_.back();
+        calendar_.pop_back();
+        now_ = event.time;
+
+        switch (event.type) {
+            case EventType::ARRIVAL: {
+                const Job& job = jobs_[event.target];
+                bool validDisks = std::all_of(job.disks.begin(), job.disks.end(), [&](int disk) { 
+                    return disk >= 0 && disk < static_cast<int>(diskPID_.size()); 
+                });
+                bool validShape = job.cpuBursts.size() == job.disks.size() + 1;
+                if (!validDisks || !validShape || job.size == 0 || job.size > userRAM_) {
+                    ++rejected_;
+                    break;
+                }
+                admission_.push_back(event.target);
+                admit();
+                sync();
+                break;
+            }
+            case EventType::CPU_DONE:
+                if (event.stamp == cpuStamp_[event.target]) {
+                    cpuDone(event.target);
+                }
+                break;
+            case EventType::DISK_DONE:
+                if (event.stamp == diskStamp_[event.target]) {
+                    diskDone(event.target);
+                }
+                break;
+        }
+    }
+
+    //busy periods still open count up to now
+    EngineReport report;
+    report.makespan = jobs_.empty() ? 0 : std::max(0.0, now_ - firstArrival_);
+    report.completed = completed_;
+    report.rejected = rejected_;
+    report.stranded = static_cast<size_t>(nextPID_ - 2) - completed_ + admission_.size();
+    if (report.makespan > 0) {
+        double cpuBusy = cpuBusy_;
+        for (size_t core = 0; core < cpuPID_.size(); ++core) {
+            cpuBusy += cpuPID_[core] > 1 ? now_ - cpuSince_[core] : 0;
+        }
+        report.throughput = completed_ / report.makespan;
+        report.cpuUtilisation = cpuBusy / (report.makespan * cpuPID_.size());
+        for (size_t disk = 0; disk < diskBusy_.size(); ++disk) {
+            double diskBusy = diskBusy_[disk] + (diskPID_[disk] ? now_ - diskSince_[disk] : 0);
+            report.diskUtilisation.push_back(diskBusy / report.makespan);
+        }
+    } else {
+        report.diskUtilisation.assign(diskBusy_.size(), 0);
+    }
+    if (completed_ > 0) {
+        report.avgTurnaround = turnaroundSum_ / completed_;
+        report.avgWaiting = waitingSum_ / completed_;
+    }
+    report.maxTurnaround = maxTurnaround_;
+    return report;
+}
+
+//FIFO admission, a job that doesn't fit blocks the ones behind it until something exits
+void EventEngine::admit() {
+    while (!admission_.empty()) {
+        int index = admission_.front();
+        const Job& job = jobs_[index];
+        if (!sim_.NewProcess(job.size, job.priority)) {
+            return;
+        }
+        if (nextPID_ >= static_cast<int>(byPID_.size())) {
+            byPID_.resize(nextPID_ + 1);
+        }
+        byPID_[nextPID_++] = Running{index, 0, job.cpuBursts[0], 0};
+        admission_.pop_front();
+    }
+}
+
+//the process on this core finished its burst -> next disk read or exit
+void EventEngine::cpuDone(int coreId) {
+    int PID = cpuPID_[coreId];
+    cpuBusy_ += now_ - cpuSince_[coreId];
+    cpuPID_[coreId] = NO_PROCESS;
+    Running& running = byPID_[PID];
+    running.remaining = 0;
+    const Job& job = jobs_[running.job];
+
+    if (running.phase < job.disks.size()) {
+        sim_.DiskReadRequest(coreId, job.disks[running.phase], JOB_FILE);
+    } else {
+        sim_.SimExit(coreId);
+        double cpuTime = 0;
+        for (double burst : job.cpuBursts) {
+            cpuTime += burst;
+        }
+        double turnaround = now_ - job.arrival;
+        ++completed_;
+        turnaroundSum_ += turnaround;
+        maxTurnaround_ = std::max(maxTurnaround_, turnaround);
+        waitingSum_ += std::max(0.0, turnaround - cpuTime - running.diskTime);
+        admit();
+    }
+    sync();
+}
+
+//the read on this disk is done -> its process, and any merged into the same job (DiskSettings::merge),
+//go back to the ready queue for their next burst
+void EventEngine::diskDone(int diskNumber) {
+    int PID = diskPID_[diskNumber];
+    double service = now_ - diskSince_[diskNumber];
+    diskBusy_[diskNumber] += service;
+    diskPID_[diskNumber] = 0;
+    if (diskRead_[diskNumber]) {
+        readDone(PID, service);
+    }
+    for (auto& rider : sim_.ViewDiskRiders(diskNumber)) {
+        if (rider.fileName == JOB_FILE) {
+            readDone(rider.PID, service);
+        }
+    }
+    sim_.DiskJobCompleted(diskNumber);
+    sync();
+}
+
+void EventEngine::readDone(int PID, double service) {
+    Running& running = byPID_[PID];
+    running.diskTime += service;
+    running.remaining = jobs_[running.job].cpuBursts[++running.phase];
+}
+
+void EventEngine::sync() {
+    //close every core that changed before opening any -> a process that moved cores keeps its burst
+    size_t cores = cpuPID_.size();
+    for (size_t core = 0; core < cores; ++core) {
+        int cpu = sim_.GetCPU(static_cast<int>(core));
+        cpu = cpu > 1 ? cpu : NO_PROCESS;   //the OS process holding a core means idle
+        if (cpu != cpuPID_[core] && cpuPID_[core] != NO_PROCESS) {
+            //whoever we saw last was preempted, keep what is left of its burst
+            double elapsed = now_ - cpuSince_[core];
+            cpuBusy_ += elapsed;
+            byPID_[cpuPID_[core]].remaining -= elapsed;
+            cpuPID_[core] = NO_PROCESS;
+            cpuSince_[core] = now_;
+            ++cpuStamp_[core];
+        }
+    }
+    for (size_t core = 0; core < cores; ++core) {
+        int cpu = sim_.GetCPU(static_cast<int>(core));
+        cpu = cpu > 1 ? cpu : NO_PROCESS;
+        if (cpu != cpuPID_[core]) {
+            cpuPID_[core] = cpu;
+            cpuSince_[core] = now_;
+            ++cpuStamp_[core];
+            schedule(now_ + byPID_[cpu].remaining, EventType::CPU_DONE, static_cast<int>(core), cpuStamp_[core]);
+        }
+    }
+
+    for (size_t disk = 0; disk < diskPID_.size(); ++disk) {
+        auto request = sim_.GetDisk(static_cast<int>(disk));
+        int PID = request.PID;
+        if (PID != diskPID_[disk]) {
+            diskPID_[disk] = PID;
+            diskRead_[disk] = request.fileName == JOB_FILE;
+            diskSince_[disk] = now_;
+            ++diskStamp_[disk];
+            if (PID != 0) {
+                schedule(now_ + serviceTime(static_cast<int>(disk)), EventType::DISK_DONE, static_cast<int>(disk), diskStamp_[disk]);
+            }
+        }
+    }
+}
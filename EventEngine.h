@@ -0,0 +1,130 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+#include "Random.h"
+#include "SimOS.h"
+
+//How long a disk takes to serve one read
+enum class ServiceModel {
+    FIXED,              //a
+    UNIFORM,            //[a, b]
+    EXPONENTIAL         //mean a
+};
+
+struct DiskModel {
+    ServiceModel type{ServiceModel::FIXED};
+    double a{1};
+    double b{1};
+};
+
+//One process from arrival to exit
+//runs cpuBursts[0], reads from disks[0], runs cpuBursts[1], ... then exits after the last burst
+//so cpuBursts.size() must be disks.size() + 1
+struct Job {
+    double arrival{0};
+    unsigned long long size{1};
+    int priority{1};
+    std::vector<double> cpuBursts{1};
+    std::vector<int> disks;
+};
+
+struct EngineReport {
+    double makespan{0};             //first arrival to last event
+    size_t completed{0};
+    size_t rejected{0};             //bigger than all of user RAM
+    size_t stranded{0};             //still waiting for RAM / running when the run stopped
+    double throughput{0};           //completed per unit of time
+    double avgTurnaround{0};
+    double maxTurnaround{0};
+    double avgWaiting{0};           //turnaround - CPU time - disk service time
+    double cpuUtilisation{0};       //share of the makespan a user process held a CPU, averaged over the cores
+    std::vector<double> diskUtilisation;
+};
+
+//Discrete event driver on top of SimOS
+//Jobs arrive, burn CPU, read disks and exit on a simulated clock; the engine makes the
+//NewProcess / DiskReadRequest / DiskJobCompleted / SimExit calls itself at the right times
+//Preemption is whatever SimOS decides: after every call the engine looks at who holds each
+//core and disk and (re)schedules the matching completion event (SimOSConfig::cores are all followed)
+//The engine is the only caller of its SimOS (PIDs are tracked by counting admissions)
+//Its own reads are all of file "job": anything else on a disk (SimOSConfig::swap writes and reads,
+//paged swap-ins) keeps the disk busy but moves no job on
+class EventEngine {
+    public:
+        EventEngine(int numberOfDisks, unsigned long long amountOfRAM, unsigned long long sizeOfOS, 
+                    std::vector<DiskModel> diskModels, std::uint64_t seed = 1, const SimOSConfig& config = SimOSConfig{});
+
+        void submit(const Job& job);
+        //process events up to time until, jobs that don't fit in free RAM wait in FIFO order
+        EngineReport run(double until = std::numeric_limits<double>::infinity());
+
+        double now() const;
+        const SimOS& sim() const;
+
+    private:
+        enum class EventType : std::uint8_t { ARRIVAL, CPU_DONE, DISK_DONE };
+        struct Event {
+            double time;
+            std::uint64_t sequence;         //FIFO among events at the same time
+            EventType type;
+            int target;                     //job index / core / disk number
+            std::uint64_t stamp;            //stale if the core/disk moved on since
+        };
+        struct Later {
+            bool operator()(const Event& a, const Event& b) const {
+                return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+            }
+        };
+        struct Running {
+            int job{-1};
+            size_t phase{0};
+            double remaining{0};            //of the current CPU burst
+            double diskTime{0};             //service received so far
+        };
+
+        SimOS sim_;
+        unsigned long long userRAM_;
+        std::vector<DiskModel> diskModels_;
+        Random random_;
+        std::vector<Job> jobs_;
+        std::vector<Event> calendar_;       //min heap on (time, sequence)
+        std::uint64_t sequence_;
+        double now_;
+        double firstArrival_;
+
+        //PID -> job progress, PIDs are handed out in admission order
+        std::vector<Running> byPID_;
+        int nextPID_;
+        std::deque<int> admission_;         //jobs waiting for RAM
+
+        //who the engine last saw on each core / disk
+        std::vector<int> cpuPID_;
+        std::vector<double> cpuSince_;
+        std::vector<std::uint64_t> cpuStamp_;
+        static constexpr const char* JOB_FILE {"job"};
+        std::vector<int> diskPID_;
+        std::vector<bool> diskRead_;        //in service is a job read, not swap traffic
+        std::vector<double> diskSince_;
+        std::vector<std::uint64_t> diskStamp_;
+
+        //metrics
+        double cpuBusy_;
+        std::vector<double> diskBusy_;
+        size_t completed_;
+        size_t rejected_;
+        double turnaroundSum_;
+        double maxTurnaround_;
+        double waitingSum_;
+
+        void schedule(double time, EventType type, int target, std::uint64_t stamp);
+        double serviceTime(int diskNumber);
+        void admit();
+        void cpuDone(int coreId);
+        void diskDone(int diskNumber);
+        void readDone(int PID, double service);
+        void sync();                        //pick up core / disk changes after SimOS calls
+};
@@ -0,0 +1,100 @@
+//Jacky Qiu
+//----------------------------------
+#include <iterator>
+#include "FreeHoleIndex.h"
+
+void FreeHoleIndex::reset(unsigned long long amountOfRAM) {
+    holesByAddress_.clear();
+    holesBySize_.clear();
+    histogram_.clear();
+    addHole(0, amountOfRAM);
+}
+
+void FreeHoleIndex::addHole(unsigned long long address, unsigned long long size) {
+    //empty holes are not tracked
+    if (size == 0) {
+        return;
+    }
+    holesByAddress_[address] = size;
+    holesBySize_.insert({size, address});
+    histogram_.add(size);
+}
+
+void FreeHoleIndex::removeHole(AddressMap::iterator hole) {
+    holesBySize_.erase({hole->second, hole->first});
+    histogram_.remove(hole->second);
+    holesByAddress_.erase(hole);
+}
+
+bool FreeHoleIndex::worstFit(unsigned long long size, unsigned long long& address) const {
+    if (holesBySize_.empty()) {
+        return false;
+    }
+    auto largest = holesBySize_.rbegin()->first;
+    if (largest < size) {
+        return false;
+    }
+    //lowest address among the largest holes
+    address = holesBySize_.lower_bound({largest, 0})->second;
+    return true;
+}
+
+bool FreeHoleIndex::bestFit(unsigned long long size, unsigned long long& address) const {
+    auto hole = holesBySize_.lower_bound({size, 0});
+    if (hole == holesBySize_.end()) {
+        return false;
+    }
+    address = hole->second;
+    return true;
+}
+
+void FreeHoleIndex::allocate(unsigned long long address, unsigned long long size) {
+    auto hole = holesByAddress_.find(address);
+    if (hole == holesByAddress_.end()) {
+        return;
+    }
+    auto holeSize = hole->second;
+    removeHole(hole);
+    //leftover stays free right after the new item
+    if (holeSize > size) {
+        addHole(address + size, holeSize - size);
+    }
+}
+
+void FreeHoleIndex::release(unsigned long long address, unsigned long long size) {
+    auto newAddress = address;
+    auto newSize = size;
+
+    //merge with hole right after
+    auto next = holesByAddress_.lower_bound(address);
+    if (next != holesByAddress_.end() && next->first == address + size) {
+        newSize += next->second;
+        removeHole(next);
+    }
+    //merge with hole right before
+    next = holesByAddress_.lower_bound(address);
+    if (next != holesByAddress_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == address) {
+            newAddress = prev->first;
+            newSize += prev->second;
+            removeHole(prev);
+        }
+    }
+    addHole(newAddress, newSize);
+}
+
+unsigned long long FreeHoleIndex::largestHole() const {
+    if (holesBySize_.empty()) {
+        return 0;
+    }
+    return holesBySize_.rbegin()->first;
+}
+
+size_t FreeHoleIndex::holeCount() const {
+    return holesByAddress_.size();
+}
+
+const HoleHistogram& FreeHoleIndex::histogram() const {
+    return histogram_;
+}
@@ -0,0 +1,46 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <map>
+#include <set>
+#include <utility>
+#include "HoleHistogram.h"
+#include "NodePool.h"
+
+//Index of free holes in RAM
+//Holes are kept by address (for coalescing) and by size (for worst/best fit)
+//Adjacent holes are always merged so the index matches the gaps between MemoryItems
+class FreeHoleIndex {
+    public:
+        //whole range [0, amountOfRAM) becomes one hole
+        void reset(unsigned long long amountOfRAM);
+
+        //largest hole (lowest address on ties), false if it can't hold size
+        bool worstFit(unsigned long long size, unsigned long long& address) const;
+        //smallest hole that can hold size (lowest address on ties)
+        bool bestFit(unsigned long long size, unsigned long long& address) const;
+
+        //carve [address, address+size) out of the hole that starts at address
+        void allocate(unsigned long long address, unsigned long long size);
+        //give [address, address+size) back, merging with neighbor holes
+        void release(unsigned long long address, unsigned long long size);
+
+        unsigned long long largestHole() const;
+        size_t holeCount() const;
+        const HoleHistogram& histogram() const;
+
+    private:
+        using Hole = std::pair<unsigned long long, unsigned long long>;
+        using AddressMap = std::map<unsigned long long, unsigned long long, std::less<unsigned long long>, 
+                                    PoolAllocator<std::pair<const unsigned long long, unsigned long long>>>;
+        using SizeSet = std::set<Hole, std::less<Hole>, PoolAllocator<Hole>>;
+
+        //tree nodes are recycled through the pool -> splitting/merging holes doesn't malloc
+        NodePool pool_;
+        AddressMap holesByAddress_ {AddressMap::allocator_type{&pool_}};   //address -> size
+        SizeSet holesBySize_ {SizeSet::allocator_type{&pool_}};            //(size, address)
+        HoleHistogram histogram_;
+
+        void addHole(unsigned long long address, unsigned long long size);
+        void removeHole(AddressMap::iterator hole);
+};
@@ -0,0 +1,34 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <array>
+
+//Free holes by log2 of their size, bucket k counts holes of [2^k, 2^(k+1)) bytes
+//The hole structures update it as holes come and go, so reading it never walks the holes
+struct HoleHistogram {
+    std::array<unsigned long long, 64> buckets{};
+    unsigned long long holes{0};
+    unsigned long long freeBytes{0};
+
+    static int bucketOf(unsigned long long size) {
+        return 63 - __builtin_clzll(size);
+    }
+    //empty holes are not counted
+    void add(unsigned long long size) {
+        if (size > 0) {
+            ++buckets[bucketOf(size)];
+            ++holes;
+            freeBytes += size;
+        }
+    }
+    void remove(unsigned long long size) {
+        if (size > 0) {
+            --buckets[bucketOf(size)];
+            --holes;
+            freeBytes -= size;
+        }
+    }
+    void clear() {
+        *this = HoleHistogram{};
+    }
+};
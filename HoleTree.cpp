@@ -0,0 +1,211 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include "HoleTree.h"
+
+HoleTree::HoleTree() :
+    root_{NIL},
+    count_{0},
+    seed_{2463534242u} {
+}
+
+void HoleTree::reset(unsigned long long amountOfRAM) {
+    nodes_.clear();
+    freeNodes_.clear();
+    root_ = NIL;
+    count_ = 0;
+    histogram_.clear();
+    if (amountOfRAM > 0) {
+        insert(0, amountOfRAM);
+    }
+}
+
+int HoleTree::newNode(unsigned long long address, unsigned long long size) {
+    //xorshift -> deterministic treap shape for the same call sequence
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 17;
+    seed_ ^= seed_ << 5;
+    Node node {address, size, size, seed_, NIL, NIL};
+    if (!freeNodes_.empty()) {
+        int index = freeNodes_.back();
+        freeNodes_.pop_back();
+        nodes_[index] = node;
+        return index;
+    }
+    nodes_.push_back(node);
+    return static_cast<int>(nodes_.size()) - 1;
+}
+
+unsigned long long HoleTree::maxOf(int node) const {
+    return node == NIL ? 0 : nodes_[node].maxSize;
+}
+
+void HoleTree::pull(int node) {
+    nodes_[node].maxSize = std::max({nodes_[node].size, maxOf(nodes_[node].left), maxOf(nodes_[node].right)});
+}
+
+void HoleTree::split(int node, unsigned long long address, int& left, int& right) {
+    if (node == NIL) {
+        left = right = NIL;
+        return;
+    }
+    if (nodes_[node].address < address) {
+        split(nodes_[node].right, address, nodes_[node].right, right);
+        left = node;
+    } else {
+        split(nodes_[node].left, address, left, nodes_[node].left);
+        right = node;
+    }
+    pull(node);
+}
+
+int HoleTree::merge(int left, int right) {
+    if (left == NIL) {
+        return right;
+    }
+    if (right == NIL) {
+        return left;
+    }
+    if (nodes_[left].heapKey > nodes_[right].heapKey) {
+        nodes_[left].right = merge(nodes_[left].right, right);
+        pull(left);
+        return left;
+    }
+    nodes_[right].left = merge(left, nodes_[right].left);
+    pull(right);
+    return right;
+}
+
+int HoleTree::leftmostFit(int node, unsigned long long size) const {
+    if (maxOf(node) < size) {
+        return NIL;
+    }
+    while (node != NIL) {
+        if (maxOf(nodes_[node].left) >= size) {
+            node = nodes_[node].left;
+        } else if (nodes_[node].size >= size) {
+            return node;
+        } else {
+            node = nodes_[node].right;
+        }
+    }
+    return NIL;
+}
+
+int HoleTree::find(unsigned long long address) const {
+    int node = root_;
+    while (node != NIL && nodes_[node].address != address) {
+        node = address < nodes_[node].address ? nodes_[node].left : nodes_[node].right;
+    }
+    return node;
+}
+
+int HoleTree::predecessor(unsigned long long address) const {
+    int node = root_;
+    int result = NIL;
+    while (node != NIL) {
+        if (nodes_[node].address < address) {
+            result = node;
+            node = nodes_[node].right;
+        } else {
+            node = nodes_[node].left;
+        }
+    }
+    return result;
+}
+
+int HoleTree::successor(unsigned long long address) const {
+    int node = root_;
+    int result = NIL;
+    while (node != NIL) {
+        if (nodes_[node].address >= address) {
+            result = node;
+            node = nodes_[node].left;
+        } else {
+            node = nodes_[node].right;
+        }
+    }
+    return result;
+}
+
+void HoleTree::insert(unsigned long long address, unsigned long long size) {
+    //empty holes are not tracked
+    if (size == 0) {
+        return;
+    }
+    int left, right;
+    split(root_, address, left, right);
+    root_ = merge(merge(left, newNode(address, size)), right);
+    ++count_;
+    histogram_.add(size);
+}
+
+void HoleTree::erase(unsigned long long address) {
+    int left, middle, right;
+    split(root_, address, left, right);
+    split(right, address + 1, middle, right);
+    if (middle != NIL) {
+        freeNodes_.push_back(middle);
+        --count_;
+        histogram_.remove(nodes_[middle].size);
+    }
+    root_ = merge(left, right);
+}
+
+bool HoleTree::firstFit(unsigned long long size, unsigned long long fromAddress, unsigned long long& address) {
+    //only look at holes at or after fromAddress
+    int left, right;
+    split(root_, fromAddress, left, right);
+    int fit = leftmostFit(right, size);
+    root_ = merge(left, right);
+    if (fit == NIL) {
+        return false;
+    }
+    address = nodes_[fit].address;
+    return true;
+}
+
+void HoleTree::allocate(unsigned long long address, unsigned long long size) {
+    int hole = find(address);
+    if (hole == NIL) {
+        return;
+    }
+    auto holeSize = nodes_[hole].size;
+    erase(address);
+    //leftover stays free right after the new item
+    if (holeSize > size) {
+        insert(address + size, holeSize - size);
+    }
+}
+
+void HoleTree::release(unsigned long long address, unsigned long long size) {
+    auto newAddress = address;
+    auto newSize = size;
+
+    //merge with hole right after
+    int next = successor(address);
+    if (next != NIL && nodes_[next].address == address + size) {
+        newSize += nodes_[next].size;
+        erase(nodes_[next].address);
+    }
+    //merge with hole right before
+    int prev = predecessor(address);
+    if (prev != NIL && nodes_[prev].address + nodes_[prev].size == address) {
+        newAddress = nodes_[prev].address;
+        newSize += nodes_[prev].size;
+        erase(nodes_[prev].address);
+    }
+    insert(newAddress, newSize);
+}
+
+unsigned long long HoleTree::largestHole() const {
+    return maxOf(root_);
+}
+
+size_t HoleTree::holeCount() const {
+    return count_;
+}
+
+const HoleHistogram& HoleTree::histogram() const {
+    return histogram_;
+}
@@ -0,0 +1,57 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <vector>
+#include "HoleHistogram.h"
+
+//Free holes kept in address order inside a treap
+//Every node also stores the largest hole in its subtree so
+//"lowest address hole that fits" is answered in O(log n) (first fit / next fit)
+class HoleTree {
+    public:
+        HoleTree();
+
+        //whole range [0, amountOfRAM) becomes one hole
+        void reset(unsigned long long amountOfRAM);
+
+        //lowest address hole at or after fromAddress that can hold size
+        bool firstFit(unsigned long long size, unsigned long long fromAddress, unsigned long long& address);
+
+        //carve [address, address+size) out of the hole that starts at address
+        void allocate(unsigned long long address, unsigned long long size);
+        //give [address, address+size) back, merging with neighbor holes
+        void release(unsigned long long address, unsigned long long size);
+
+        unsigned long long largestHole() const;
+        size_t holeCount() const;
+        const HoleHistogram& histogram() const;
+
+    private:
+        static constexpr int NIL {-1};
+        struct Node {
+            unsigned long long address;
+            unsigned long long size;
+            unsigned long long maxSize;     //largest hole in this subtree
+            unsigned int heapKey;           //random treap priority
+            int left;
+            int right;
+        };
+        std::vector<Node> nodes_;
+        std::vector<int> freeNodes_;
+        int root_;
+        size_t count_;
+        unsigned int seed_;
+        HoleHistogram histogram_;
+
+        int newNode(unsigned long long address, unsigned long long size);
+        unsigned long long maxOf(int node) const;
+        void pull(int node);
+        void split(int node, unsigned long long address, int& left, int& right);     //left < address <= right
+        int merge(int left, int right);
+        int leftmostFit(int node, unsigned long long size) const;
+        int find(unsigned long long address) const;
+        int predecessor(unsigned long long address) const;  //largest address <  address
+        int successor(unsigned long long address) const;    //smallest address >= address
+        void insert(unsigned long long address, unsigned long long size);
+        void erase(unsigned long long address);
+};
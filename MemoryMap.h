@@ -0,0 +1,20 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <map>
+#include <vector>
+#include "NodePool.h"
+
+//FOR RAM
+struct MemoryItem {
+    unsigned long long itemAddress;
+    unsigned long long itemSize;
+    int PID; 
+};
+using MemoryUse = std::vector<MemoryItem>;
+
+//resident items by address, nodes from a NodePool
+//a zero-size item keeps the start of its hole -> the next item placed there shares the address,
+//equal addresses stay in placement order
+using RAMAllocator = PoolAllocator<std::pair<const unsigned long long, MemoryItem>>;
+using RAMMap = std::multimap<unsigned long long, MemoryItem, std::less<unsigned long long>, RAMAllocator>;
@@ -0,0 +1,46 @@
+//Jacky Qiu
+//----------------------------------
+#include <new>
+#include "NodePool.h"
+
+NodePool::~NodePool() {
+    for (auto chunk : chunks_) {
+        ::operator delete(chunk);
+    }
+}
+
+void* NodePool::allocate(std::size_t bytes) {
+    //arrays (hash buckets, etc) go straight to the heap
+    if (bytes == 0 || bytes > GRANULE * SIZE_CLASSES) {
+        return ::operator new(bytes);
+    }
+    std::size_t sizeClass = (bytes - 1) / GRANULE;
+    if (freeLists_[sizeClass] != nullptr) {
+        FreeNode* node = freeLists_[sizeClass];
+        freeLists_[sizeClass] = node->next;
+        return node;
+    }
+
+    //carve from the current chunk, start a new one when it runs out
+    std::size_t rounded = (sizeClass + 1) * GRANULE;
+    if (bumpLeft_ < rounded) {
+        bump_ = static_cast<char*>(::operator new(CHUNK_BYTES));
+        chunks_.push_back(bump_);
+        bumpLeft_ = CHUNK_BYTES;
+    }
+    void* result = bump_;
+    bump_ += rounded;
+    bumpLeft_ -= rounded;
+    return result;
+}
+
+void NodePool::deallocate(void* ptr, std::size_t bytes) {
+    if (bytes == 0 || bytes > GRANULE * SIZE_CLASSES) {
+        ::operator delete(ptr);
+        return;
+    }
+    std::size_t sizeClass = (bytes - 1) / GRANULE;
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    node->next = freeLists_[sizeClass];
+    freeLists_[sizeClass] = node;
+}
@@ -0,0 +1,61 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstddef>
+#include <vector>
+
+//Free-list pool for small fixed size nodes (map/set/hash nodes)
+//Memory comes from 64KB chunks and is recycled per size class,
+//so steady churn (exit + fork) never reaches malloc
+class NodePool {
+    public:
+        NodePool() = default;
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+        ~NodePool();
+
+        void* allocate(std::size_t bytes);
+        void deallocate(void* ptr, std::size_t bytes);
+
+    private:
+        static constexpr std::size_t GRANULE {16};
+        static constexpr std::size_t SIZE_CLASSES {16};         //pooled up to 256 bytes
+        static constexpr std::size_t CHUNK_BYTES {64 * 1024};
+        struct FreeNode {
+            FreeNode* next;
+        };
+        FreeNode* freeLists_[SIZE_CLASSES] {};
+        std::vector<char*> chunks_;
+        char* bump_ {nullptr};
+        std::size_t bumpLeft_ {0};
+};
+
+//std allocator that hands out nodes from a NodePool
+//The pool must outlive every container that uses it
+template <typename T>
+class PoolAllocator {
+    public:
+        using value_type = T;
+
+        explicit PoolAllocator(NodePool* pool) : pool_{pool} {}
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>& other) : pool_{other.pool_} {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(pool_->allocate(n * sizeof(T)));
+        }
+        void deallocate(T* ptr, std::size_t n) {
+            pool_->deallocate(ptr, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U>& other) const {
+            return pool_ == other.pool_;
+        }
+        template <typename U>
+        bool operator!=(const PoolAllocator<U>& other) const {
+            return pool_ != other.pool_;
+        }
+
+        NodePool* pool_;
+};
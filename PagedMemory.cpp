@@ -0,0 +1,484 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include <iterator>
+#include "PagedMemory.h"
+
+PagedMemory::PagedMemory(const MemorySettings& settings, unsigned long long amountOfRAM, RAMMap& ram) :
+    settings_{settings},
+    ram_{ram},
+    freeCount_{0},
+    frameCursor_{0},
+    osFrames_{0},
+    slotCount_{0},
+    slotCursor_{0},
+    committed_{0},
+    clock_{0},
+    loads_{0},
+    hand_{0} {
+
+    if (settings_.pageSize == 0) {
+        settings_.pageSize = 1;
+    }
+    if (settings_.agingInterval == 0) {
+        settings_.agingInterval = 1;
+    }
+    size_t frames = static_cast<size_t>(amountOfRAM / settings_.pageSize);
+    frames_.assign(frames, Frame{});
+    freeFrames_.assign((frames + 63) / 64, 0);
+    for (size_t frame = 0; frame < frames; ++frame) {
+        putBit(freeFrames_, frame);
+    }
+    freeCount_ = frames;
+}
+
+unsigned long long PagedMemory::pagesFor(unsigned long long size) const {
+    return size / settings_.pageSize + (size % settings_.pageSize != 0);
+}
+
+//first set bit at or after the cursor word (wrapping), cleared and returned, -1 if none
+long long PagedMemory::takeBit(std::vector<std::uint64_t>& bits, size_t& cursor) {
+    size_t words = bits.size();
+    for (size_t step = 0; step < words; ++step) {
+        size_t word = (cursor + step) % words;
+        if (bits[word]) {
+            size_t index = word * 64 + __builtin_ctzll(bits[word]);
+            bits[word] &= bits[word] - 1;
+            cursor = word;
+            return static_cast<long long>(index);
+        }
+    }
+    return NONE;
+}
+
+void PagedMemory::putBit(std::vector<std::uint64_t>& bits, size_t index) {
+    bits[index / 64] |= 1ULL << (index % 64);
+}
+
+bool PagedMemory::admitOS(int PID, unsigned long long size) {
+    //at least one frame so the OS shows up in the memory view
+    auto pages = std::max<unsigned long long>(1, pagesFor(size));
+    if (pages > frames_.size() || osFrames_ != 0) {
+        return false;
+    }
+    for (size_t frame = 0; frame < pages; ++frame) {
+        freeFrames_[frame / 64] &= ~(1ULL << (frame % 64));
+        frames_[frame].PID = PID;
+        mapRun(static_cast<int>(frame), PID);
+    }
+    osFrames_ = static_cast<size_t>(pages);
+    freeCount_ -= osFrames_;
+    stats_.privateBytes += osFrames_ * settings_.pageSize;
+    hand_ = osFrames_;
+
+    //swap only behind a disk, and never more than it can take
+    auto userFrames = frames_.size() - osFrames_;
+    slotCount_ = settings_.swapDisk < 0 ? 0 : (settings_.swapPages ? static_cast<size_t>(settings_.swapPages) : userFrames);
+    freeSlots_.assign((slotCount_ + 63) / 64, 0);
+    for (size_t slot = 0; slot < slotCount_; ++slot) {
+        putBit(freeSlots_, slot);
+    }
+    return true;
+}
+
+//commit limit: every page content (shared ones once) has a frame or a swap slot to go to
+unsigned long long PagedMemory::limit() const {
+    return frames_.size() - osFrames_ + slotCount_;
+}
+
+bool PagedMemory::canAdmit(unsigned long long size) const {
+    return osFrames_ != 0 && frames_.size() != osFrames_ && committed_ + pagesFor(size) <= limit();
+}
+
+int PagedMemory::newTable(int PID, unsigned long long pages) {
+    int table;
+    if (!freeTables_.empty()) {
+        table = freeTables_.back();
+        freeTables_.pop_back();
+    } else {
+        table = static_cast<int>(tables_.size());
+        tables_.emplace_back();
+        tableOwners_.push_back(0);
+    }
+    tables_[table].assign(static_cast<size_t>(pages), Page{});
+    tableOwners_[table] = PID;
+    return table;
+}
+
+void PagedMemory::admit(Process* ptr) {
+    auto pages = pagesFor(ptr->size_);
+    int table = newTable(ptr->PID_, pages);
+    committed_ += pages;
+    ptr->pageTable_ = table;
+
+    //map what fits right away, the rest is demand zero
+    for (unsigned long long page = 0; page < pages && freeCount_ > 0; ++page) {
+        load(static_cast<int>(takeBit(freeFrames_, frameCursor_)), ptr->PID_, table, page);
+        --freeCount_;
+        stats_.privateBytes += settings_.pageSize;
+    }
+}
+
+void PagedMemory::release(Process* ptr) {
+    int table = ptr->pageTable_;
+    if (table < 0) {
+        return;
+    }
+    auto pages = tables_[table].size();
+    for (size_t pageNumber = 0; pageNumber < pages; ++pageNumber) {
+        auto& page = tables_[table][pageNumber];
+        if (page.nextShare != NONE) {
+            //the other sharers keep the content (and its commit)
+            leave(table, pageNumber);
+            continue;
+        }
+        if (page.frame != NONE) {
+            unload(page.frame);
+            stats_.privateBytes -= settings_.pageSize;
+        }
+        if (page.swapSlot != NONE) {
+            putBit(freeSlots_, static_cast<size_t>(page.swapSlot));
+            --stats_.swappedPages;
+            stats_.privateBytes -= settings_.pageSize;
+        }
+        --committed_;
+    }
+    tables_[table].clear();
+    freeTables_.push_back(table);
+    ptr->pageTable_ = NONE;
+}
+
+//pages the child can't share (never touched) need their own commit
+bool PagedMemory::canFork(const Process* parent) const {
+    if (parent->pageTable_ < 0) {
+        return false;
+    }
+    const auto& source = tables_[parent->pageTable_];
+    auto untouched = std::count_if(source.begin(), source.end(), [](const Page& page) {
+        return page.frame == NONE && page.swapSlot == NONE;
+    });
+    return committed_ + static_cast<unsigned long long>(untouched) <= limit();
+}
+
+void PagedMemory::fork(const Process* parent, Process* child) {
+    int source = parent->pageTable_;
+    auto pages = tables_[source].size();
+    int table = newTable(child->PID_, pages);
+    child->pageTable_ = table;
+    for (size_t page = 0; page < pages; ++page) {
+        auto& from = tables_[source][page];
+        if (from.frame == NONE && from.swapSlot == NONE) {
+            ++committed_;
+            continue;
+        }
+        if (from.nextShare == NONE) {
+            stats_.privateBytes -= settings_.pageSize;
+            stats_.sharedBytes += settings_.pageSize;
+        }
+        tables_[table][page].frame = from.frame;
+        tables_[table][page].swapSlot = from.swapSlot;
+        link(source, table, page);
+    }
+}
+
+PagedMemory::Access PagedMemory::access(Process* ptr, unsigned long long address, bool write, unsigned long long& swapSlot) {
+    int table = ptr->pageTable_;
+    if (table < 0 || address >= ptr->size_) {
+        return Access::INVALID;
+    }
+    auto pageNumber = address / settings_.pageSize;
+    auto& page = tables_[table][pageNumber];
+    bool copyOnWrite = write && page.nextShare != NONE;
+    if (copyOnWrite && committed_ + 1 > limit()) {
+        return Access::NO_MEMORY;
+    }
+    ++stats_.accesses;
+    ++clock_;
+    if (settings_.replacement == ReplacementType::LRU && stats_.accesses % settings_.agingInterval == 0) {
+        age();
+    }
+
+    auto result = Access::HIT;
+    if (page.frame != NONE) {
+        auto& frame = frames_[page.frame];
+        frame.referenced = true;
+        frame.lastUse = clock_;
+    } else {
+        ++stats_.faults;
+        result = Access::FAULT;
+        if (page.swapSlot != NONE) {
+            //slot is free again before anything is evicted, so the commit limit always leaves one
+            swapSlot = static_cast<unsigned long long>(page.swapSlot);
+            putBit(freeSlots_, swapSlot);
+            --stats_.swappedPages;
+            ++stats_.majorFaults;
+            result = Access::SWAP_IN;
+        } else {
+            stats_.privateBytes += settings_.pageSize;
+        }
+        int frame = takeFrame();
+        load(frame, ptr->PID_, table, pageNumber);
+        //every sharer maps the content again
+        for (int other = table; ; ) {
+            tables_[other][pageNumber].frame = frame;
+            tables_[other][pageNumber].swapSlot = NONE;
+            other = tables_[other][pageNumber].nextShare;
+            if (other == NONE || other == table) {
+                break;
+            }
+        }
+    }
+    if (copyOnWrite) {
+        copy(table, pageNumber);
+    }
+    return result;
+}
+
+MemoryUsage PagedMemory::usage(const Process* ptr) const {
+    MemoryUsage result;
+    if (ptr->pageTable_ < 0) {
+        return result;
+    }
+    for (const auto& page : tables_[ptr->pageTable_]) {
+        if (page.frame == NONE && page.swapSlot == NONE) {
+            continue;
+        }
+        (page.nextShare != NONE ? result.sharedBytes : result.privateBytes) += settings_.pageSize;
+    }
+    return result;
+}
+
+int PagedMemory::takeFrame() {
+    if (freeCount_ == 0) {
+        evict(victim());
+    }
+    --freeCount_;
+    return static_cast<int>(takeBit(freeFrames_, frameCursor_));
+}
+
+int PagedMemory::victim() {
+    auto frames = frames_.size();
+    switch (settings_.replacement) {
+        case ReplacementType::FIFO:
+            //stale entries (frame freed or reloaded since) are skipped
+            while (true) {
+                auto [frame, loaded] = loadOrder_.front();
+                loadOrder_.pop_front();
+                if (frames_[frame].PID != 0 && frames_[frame].loaded == loaded) {
+                    return frame;
+                }
+            }
+        case ReplacementType::CLOCK:
+            while (true) {
+                auto& frame = frames_[hand_];
+                int current = static_cast<int>(hand_);
+                hand_ = hand_ + 1 < frames ? hand_ + 1 : osFrames_;
+                if (!frame.referenced) {
+                    return current;
+                }
+                frame.referenced = false;
+            }
+        case ReplacementType::LRU: {
+            //referenced since the last aging pass counts above every aged bit
+            int best = NONE;
+            unsigned bestAge = 0;
+            for (size_t frame = osFrames_; frame < frames; ++frame) {
+                unsigned age = (frames_[frame].referenced ? 0x100u : 0u) | frames_[frame].age;
+                if (best == NONE || age < bestAge) {
+                    best = static_cast<int>(frame);
+                    bestAge = age;
+                }
+            }
+            return best;
+        }
+        case ReplacementType::WORKING_SET: {
+            //one lap from the hand, the oldest page seen is the fallback
+            int oldest = NONE;
+            for (size_t step = osFrames_; step < frames; ++step) {
+                auto& frame = frames_[hand_];
+                int current = static_cast<int>(hand_);
+                hand_ = hand_ + 1 < frames ? hand_ + 1 : osFrames_;
+                if (clock_ - frame.lastUse >= settings_.window) {
+                    return current;
+                }
+                if (oldest == NONE || frame.lastUse < frames_[oldest].lastUse) {
+                    oldest = current;
+                }
+            }
+            return oldest;
+        }
+    }
+    return NONE;
+}
+
+void PagedMemory::evict(int frame) {
+    auto& victim = frames_[frame];
+    auto slot = takeBit(freeSlots_, slotCursor_);
+    //one write to swap, every sharer finds the content there
+    for (int other = victim.table; ; ) {
+        tables_[other][victim.page].frame = NONE;
+        tables_[other][victim.page].swapSlot = slot;
+        other = tables_[other][victim.page].nextShare;
+        if (other == NONE || other == victim.table) {
+            break;
+        }
+    }
+    ++stats_.evictions;
+    ++stats_.swappedPages;
+    unload(frame);
+}
+
+void PagedMemory::load(int frame, int PID, int table, unsigned long long page) {
+    auto& loaded = frames_[frame];
+    loaded.PID = PID;
+    loaded.table = table;
+    loaded.page = page;
+    loaded.referenced = true;
+    loaded.age = 0;
+    loaded.loaded = ++loads_;
+    loaded.lastUse = clock_;
+    tables_[table][page].frame = frame;
+    mapRun(frame, PID);
+
+    if (settings_.replacement == ReplacementType::FIFO) {
+        loadOrder_.emplace_back(frame, loaded.loaded);
+        //drop stale entries now and then so exits without evictions don't grow it
+        if (loadOrder_.size() > 2 * frames_.size()) {
+            loadOrder_.erase(std::remove_if(loadOrder_.begin(), loadOrder_.end(), [this](const std::pair<int, unsigned long long>& entry) {
+                return frames_[entry.first].PID == 0 || frames_[entry.first].loaded != entry.second;
+            }), loadOrder_.end());
+        }
+    }
+}
+
+void PagedMemory::unload(int frame) {
+    auto& unloaded = frames_[frame];
+    tables_[unloaded.table][unloaded.page].frame = NONE;
+    unmapRun(frame);
+    unloaded = Frame{};
+    putBit(freeFrames_, static_cast<size_t>(frame));
+    ++freeCount_;
+}
+
+void PagedMemory::age() {
+    for (size_t frame = osFrames_; frame < frames_.size(); ++frame) {
+        auto& aged = frames_[frame];
+        aged.age = static_cast<std::uint8_t>((aged.age >> 1) | (aged.referenced ? 0x80 : 0));
+        aged.referenced = false;
+    }
+}
+
+void PagedMemory::link(int table, int child, unsigned long long page) {
+    auto& parent = tables_[table][page];
+    auto& added = tables_[child][page];
+    if (parent.nextShare == NONE) {
+        parent.prevShare = parent.nextShare = child;
+        added.prevShare = added.nextShare = table;
+        return;
+    }
+    added.prevShare = table;
+    added.nextShare = parent.nextShare;
+    tables_[parent.nextShare][page].prevShare = child;
+    parent.nextShare = child;
+}
+
+//take table out of the ring of page, returns a table still in it
+int PagedMemory::unlink(int table, unsigned long long page) {
+    auto& entry = tables_[table][page];
+    int prev = entry.prevShare;
+    int next = entry.nextShare;
+    if (prev == next) {
+        tables_[next][page].prevShare = tables_[next][page].nextShare = NONE;
+    } else {
+        tables_[prev][page].nextShare = next;
+        tables_[next][page].prevShare = prev;
+    }
+    entry.prevShare = entry.nextShare = NONE;
+    return next;
+}
+
+//table stops sharing the content of page, the content stays with the others
+void PagedMemory::leave(int table, unsigned long long page) {
+    auto& entry = tables_[table][page];
+    int other = unlink(table, page);
+    if (entry.frame != NONE && frames_[entry.frame].table == table) {
+        setOwner(entry.frame, other);
+    }
+    if (tables_[other][page].nextShare == NONE) {
+        stats_.sharedBytes -= settings_.pageSize;
+        stats_.privateBytes += settings_.pageSize;
+    }
+    entry.frame = NONE;
+    entry.swapSlot = NONE;
+}
+
+void PagedMemory::setOwner(int frame, int table) {
+    unmapRun(frame);
+    frames_[frame].table = table;
+    frames_[frame].PID = tableOwners_[table];
+    mapRun(frame, frames_[frame].PID);
+}
+
+//write to a shared page: table gets a private copy in a frame of its own
+void PagedMemory::copy(int table, unsigned long long page) {
+    leave(table, page);
+    ++committed_;
+    ++stats_.cowCopies;
+    stats_.privateBytes += settings_.pageSize;
+    load(takeFrame(), tableOwners_[table], table, page);
+}
+
+unsigned long long PagedMemory::pageSize() const {
+    return settings_.pageSize;
+}
+
+unsigned long long PagedMemory::freeBytes() const {
+    return freeCount_ * settings_.pageSize;
+}
+
+const MemoryStats& PagedMemory::stats() const {
+    return stats_;
+}
+
+const MemorySettings& PagedMemory::settings() const {
+    return settings_;
+}
+
+//frame now belongs to PID (frames_ already says so): join the runs of PID on either side
+void PagedMemory::mapRun(int frame, int PID) {
+    auto size = settings_.pageSize;
+    auto address = static_cast<unsigned long long>(frame) * size;
+    bool left = frame > 0 && frames_[frame - 1].PID == PID;
+    bool right = static_cast<size_t>(frame) + 1 < frames_.size() && frames_[frame + 1].PID == PID;
+
+    auto extra = size;
+    if (right) {
+        auto next = ram_.find(address + size);
+        extra += next->second.itemSize;
+        ram_.erase(next);
+    }
+    if (left) {
+        std::prev(ram_.upper_bound(address))->second.itemSize += extra;
+    } else {
+        ram_.emplace(address, MemoryItem{address, extra, PID});
+    }
+}
+
+//frame leaves its run (frames_ still names the owner): split the run around it
+void PagedMemory::unmapRun(int frame) {
+    auto size = settings_.pageSize;
+    auto address = static_cast<unsigned long long>(frame) * size;
+    auto run = std::prev(ram_.upper_bound(address));
+    auto start = run->second.itemAddress;
+    auto end = start + run->second.itemSize;
+    int PID = run->second.PID;
+
+    if (start == address) {
+        ram_.erase(run);
+    } else {
+        run->second.itemSize = address - start;
+    }
+    if (address + size < end) {
+        ram_.emplace(address + size, MemoryItem{address + size, end - address - size, PID});
+    }
+}
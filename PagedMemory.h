@@ -0,0 +1,144 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "MemoryMap.h"
+#include "Process.h"
+
+//Which resident page gives up its frame when none is free
+enum class ReplacementType {
+    FIFO,           //oldest loaded page
+    CLOCK,          //second chance over the frames
+    LRU,            //LRU approximation: reference bits aged into 8 bit counters, lowest counter goes
+    WORKING_SET     //WSClock: hand stops at the first page not used within the window, else the least recently used
+};
+
+struct MemorySettings {
+    bool paged{false};                      //false = contiguous placement (PlacementType)
+    unsigned long long pageSize{4096};
+    ReplacementType replacement{ReplacementType::FIFO};
+    int swapDisk{-1};                       //disk swapped pages are read back from, -1 = no swap (nothing is evicted)
+    unsigned long long swapPages{0};        //swap slots, 0 = as many as there are user frames
+    unsigned long long window{64};          //WORKING_SET: accesses a page stays in the working set
+    unsigned long long agingInterval{16};   //LRU: accesses between two aging passes
+    bool copyOnWrite{false};                //SimFork shares the parent's memory until one of them writes
+};
+
+struct MemoryStats {
+    unsigned long long accesses{0};
+    unsigned long long faults{0};           //page not resident
+    unsigned long long majorFaults{0};      //of those, read back from swap
+    unsigned long long evictions{0};        //resident page written to swap to free its frame
+    unsigned long long swappedPages{0};     //in swap right now
+    unsigned long long cowCopies{0};        //private copies made by writes to shared memory
+    unsigned long long sharedBytes{0};      //held by more than one process, counted once
+    unsigned long long privateBytes{0};     //held by one process (paged: resident or swapped pages only)
+};
+
+//One process' memory (SimOS::GetMemoryUsage)
+struct MemoryUsage {
+    unsigned long long sharedBytes{0};
+    unsigned long long privateBytes{0};
+};
+
+//Paged RAM for SimOS (MemorySettings::paged)
+//Frames are pageSize bytes; a free-frame bitmap is scanned a 64 bit word at a time from a rotating cursor
+//Each process gets a page table (Process::pageTable_); admission commits its pages against
+//frames + swap, maps as many as there are free frames and leaves the rest to fault in on first touch
+//Runs of consecutive frames owned by one process are kept in the RAMMap so GetMemory still sees
+//contiguous items ordered by address
+//
+//Copy on write: a forked table points at the parent's frames / swap slots. The tables sharing the
+//content of page p form a ring through their page p entries, so evicting, reading back or dropping
+//the content reaches every sharer; the frame shows up under one of them (Frame::table)
+class PagedMemory {
+    public:
+        enum class Access {
+            HIT,
+            FAULT,          //frame found, no I/O (first touch)
+            SWAP_IN,        //frame found, page must be read back from swap first
+            INVALID,        //address outside the process
+            NO_MEMORY       //write to a shared page, no room for a private copy (nothing happened)
+        };
+
+        PagedMemory(const MemorySettings& settings, unsigned long long amountOfRAM, RAMMap& ram);
+        PagedMemory(const PagedMemory&) = delete;
+        PagedMemory& operator=(const PagedMemory&) = delete;
+
+        //OS frames start at 0 and are never replaced
+        bool admitOS(int PID, unsigned long long size);
+        bool canAdmit(unsigned long long size) const;
+        void admit(Process* ptr);
+        void release(Process* ptr);
+        //copy on write fork: child gets its own page table over the parent's pages
+        bool canFork(const Process* parent) const;
+        void fork(const Process* parent, Process* child);
+        //touch one byte of ptr's memory, swapSlot = block to read on SWAP_IN
+        //a write to a shared page gives ptr a private copy of it
+        Access access(Process* ptr, unsigned long long address, bool write, unsigned long long& swapSlot);
+        MemoryUsage usage(const Process* ptr) const;
+
+        unsigned long long pageSize() const;
+        unsigned long long freeBytes() const;
+        const MemoryStats& stats() const;
+        const MemorySettings& settings() const;
+
+    private:
+        static constexpr int NONE {-1};
+        struct Page {
+            int frame{NONE};
+            long long swapSlot{NONE};
+            int prevShare{NONE};                //tables sharing this page's content, NONE = private
+            int nextShare{NONE};
+        };
+        struct Frame {
+            int PID{0};                         //0 = free
+            int table{NONE};
+            unsigned long long page{0};
+            bool referenced{false};
+            std::uint8_t age{0};
+            unsigned long long loaded{0};       //load stamp
+            unsigned long long lastUse{0};      //clock_ of the last access
+        };
+
+        MemorySettings settings_;
+        RAMMap& ram_;
+        std::vector<Frame> frames_;
+        std::vector<std::uint64_t> freeFrames_;     //1 = free
+        size_t freeCount_;
+        size_t frameCursor_;                        //word the next scan starts at
+        size_t osFrames_;
+        std::vector<std::uint64_t> freeSlots_;      //swap, 1 = free
+        size_t slotCount_;
+        size_t slotCursor_;
+        unsigned long long committed_;              //user pages admitted
+        std::vector<std::vector<Page>> tables_;
+        std::vector<int> tableOwners_;              //PID by table
+        std::vector<int> freeTables_;
+        unsigned long long clock_;                  //accesses, the virtual time of lastUse / window
+        unsigned long long loads_;                  //frames loaded, stamps FIFO entries
+        std::deque<std::pair<int, unsigned long long>> loadOrder_;     //FIFO: (frame, loaded)
+        size_t hand_;                               //CLOCK / WORKING_SET
+        MemoryStats stats_;
+
+        unsigned long long pagesFor(unsigned long long size) const;
+        unsigned long long limit() const;
+        int newTable(int PID, unsigned long long pages);
+        static long long takeBit(std::vector<std::uint64_t>& bits, size_t& cursor);
+        static void putBit(std::vector<std::uint64_t>& bits, size_t index);
+        int takeFrame();
+        int victim();
+        void evict(int frame);
+        void load(int frame, int PID, int table, unsigned long long page);
+        void unload(int frame);
+        void age();
+        void mapRun(int frame, int PID);
+        void unmapRun(int frame);
+        void link(int table, int child, unsigned long long page);
+        int unlink(int table, unsigned long long page);
+        void leave(int table, unsigned long long page);
+        void setOwner(int frame, int table);
+        void copy(int table, unsigned long long page);
+};
@@ -0,0 +1,196 @@
+//Jacky Qiu
+//----------------------------------
+#include "PlacementPolicy.h"
+
+std::unique_ptr<PlacementPolicy> makePlacementPolicy(PlacementType type) {
+    switch (type) {
+        case PlacementType::FIRST_FIT:
+            return std::make_unique<FirstFitPolicy>();
+        case PlacementType::BEST_FIT:
+            return std::make_unique<BestFitPolicy>();
+        case PlacementType::NEXT_FIT:
+            return std::make_unique<NextFitPolicy>();
+        case PlacementType::BUDDY:
+            return std::make_unique<BuddyPolicy>();
+        case PlacementType::WORST_FIT:
+        default:
+            return std::make_unique<WorstFitPolicy>();
+    }
+}
+
+//WORST FIT
+void WorstFitPolicy::reset(unsigned long long amountOfRAM) {
+    holes_.reset(amountOfRAM);
+}
+
+bool WorstFitPolicy::allocate(unsigned long long size, unsigned long long& address) {
+    if (!holes_.worstFit(size, address)) {
+        return false;
+    }
+    holes_.allocate(address, size);
+    return true;
+}
+
+void WorstFitPolicy::release(unsigned long long address, unsigned long long size) {
+    holes_.release(address, size);
+}
+
+bool WorstFitPolicy::claim(unsigned long long address, unsigned long long size) {
+    holes_.allocate(address, size);
+    return true;
+}
+
+unsigned long long WorstFitPolicy::largestHole() const {
+    return holes_.largestHole();
+}
+
+size_t WorstFitPolicy::holeCount() const {
+    return holes_.holeCount();
+}
+
+const HoleHistogram& WorstFitPolicy::histogram() const {
+    return holes_.histogram();
+}
+
+//BEST FIT
+void BestFitPolicy::reset(unsigned long long amountOfRAM) {
+    holes_.reset(amountOfRAM);
+}
+
+bool BestFitPolicy::allocate(unsigned long long size, unsigned long long& address) {
+    if (!holes_.bestFit(size, address)) {
+        return false;
+    }
+    holes_.allocate(address, size);
+    return true;
+}
+
+void BestFitPolicy::release(unsigned long long address, unsigned long long size) {
+    holes_.release(address, size);
+}
+
+bool BestFitPolicy::claim(unsigned long long address, unsigned long long size) {
+    holes_.allocate(address, size);
+    return true;
+}
+
+unsigned long long BestFitPolicy::largestHole() const {
+    return holes_.largestHole();
+}
+
+size_t BestFitPolicy::holeCount() const {
+    return holes_.holeCount();
+}
+
+const HoleHistogram& BestFitPolicy::histogram() const {
+    return holes_.histogram();
+}
+
+//FIRST FIT
+void FirstFitPolicy::reset(unsigned long long amountOfRAM) {
+    holes_.reset(amountOfRAM);
+}
+
+bool FirstFitPolicy::allocate(unsigned long long size, unsigned long long& address) {
+    if (!holes_.firstFit(size, 0, address)) {
+        return false;
+    }
+    holes_.allocate(address, size);
+    return true;
+}
+
+void FirstFitPolicy::release(unsigned long long address, unsigned long long size) {
+    holes_.release(address, size);
+}
+
+bool FirstFitPolicy::claim(unsigned long long address, unsigned long long size) {
+    holes_.allocate(address, size);
+    return true;
+}
+
+unsigned long long FirstFitPolicy::largestHole() const {
+    return holes_.largestHole();
+}
+
+size_t FirstFitPolicy::holeCount() const {
+    return holes_.holeCount();
+}
+
+const HoleHistogram& FirstFitPolicy::histogram() const {
+    return holes_.histogram();
+}
+
+//NEXT FIT
+void NextFitPolicy::reset(unsigned long long amountOfRAM) {
+    holes_.reset(amountOfRAM);
+    rover_ = 0;
+}
+
+bool NextFitPolicy::allocate(unsigned long long size, unsigned long long& address) {
+    //search from the rover, wrap around to the start of RAM
+    if (!holes_.firstFit(size, rover_, address) && !holes_.firstFit(size, 0, address)) {
+        return false;
+    }
+    holes_.allocate(address, size);
+    rover_ = address + size;
+    return true;
+}
+
+void NextFitPolicy::release(unsigned long long address, unsigned long long size) {
+    holes_.release(address, size);
+}
+
+bool NextFitPolicy::claim(unsigned long long address, unsigned long long size) {
+    holes_.allocate(address, size);
+    return true;
+}
+
+unsigned long long NextFitPolicy::largestHole() const {
+    return holes_.largestHole();
+}
+
+size_t NextFitPolicy::holeCount() const {
+    return holes_.holeCount();
+}
+
+const HoleHistogram& NextFitPolicy::histogram() const {
+    return holes_.histogram();
+}
+
+//BUDDY
+void BuddyPolicy::reset(unsigned long long amountOfRAM) {
+    blocks_.reset(amountOfRAM);
+}
+
+bool BuddyPolicy::allocate(unsigned long long size, unsigned long long& address) {
+    return blocks_.allocate(size, address);
+}
+
+void BuddyPolicy::release(unsigned long long address, unsigned long long size) {
+    blocks_.release(address, size);
+}
+
+unsigned long long BuddyPolicy::footprint(unsigned long long size) const {
+    return BuddyAllocator::blockSize(size);
+}
+
+unsigned long long BuddyPolicy::alignment(unsigned long long size) const {
+    return BuddyAllocator::blockSize(size);
+}
+
+//blocks can't move off their alignment
+bool BuddyPolicy::claim(unsigned long long, unsigned long long) {
+    return false;
+}
+
+unsigned long long BuddyPolicy::largestHole() const {
+    return blocks_.largestHole();
+}
+
+size_t BuddyPolicy::holeCount() const {
+    return blocks_.holeCount();
+}
+
+const HoleHistogram& BuddyPolicy::histogram() const {
+    return blocks_.histogram();
+}
@@ -0,0 +1,141 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <memory>
+#include "FreeHoleIndex.h"
+#include "HoleTree.h"
+#include "BuddyAllocator.h"
+
+//RAM placement strategies
+enum class PlacementType {
+    WORST_FIT,      //default, largest hole
+    FIRST_FIT,      //lowest address hole that fits
+    BEST_FIT,       //smallest hole that fits
+    NEXT_FIT,       //first fit starting where the last allocation ended
+    BUDDY           //binary buddy blocks
+};
+
+//What SimOS does when no hole fits a process but the free bytes would (not with BUDDY or paged memory)
+enum class CompactionType {
+    NONE,           //default, admission fails
+    FULL,           //slide every item down towards address 0, the free space ends up as one hole at the top
+    INCREMENTAL,    //slide items up from the lowest hole, about budget bytes per failed admission
+    MINIMAL         //slide the run of items that opens one big enough hole for the fewest bytes moved
+};
+
+struct CompactionSettings {
+    CompactionType type{CompactionType::NONE};
+    unsigned long long budget{1ULL << 20};  //INCREMENTAL: bytes moved per pass (at least one item)
+};
+
+struct CompactionStats {
+    unsigned long long compactions{0};
+    unsigned long long itemsMoved{0};
+    unsigned long long bytesMoved{0};
+    unsigned long long savedAdmissions{0};  //processes placed only thanks to a compaction
+};
+
+//Free space of RAM (SimOS::GetFragmentationStats), every field is kept up to date as holes change
+struct FragmentationStats {
+    size_t holes{0};
+    unsigned long long largestHole{0};
+    unsigned long long freeBytes{0};
+    double externalFragmentation{0.0};              //1 - largestHole / freeBytes, 0 when nothing is free
+    std::array<unsigned long long, 64> holeSizes{}; //holes by log2 of their size (HoleHistogram)
+    unsigned long long fragmentationFailures{0};    //placements refused with enough free bytes in smaller holes
+    unsigned long long capacityFailures{0};         //placements refused for lack of free bytes
+};
+
+//Strategy object SimOS places processes through
+//Each policy owns its own free space structure, all lookups are O(log n)
+class PlacementPolicy {
+    public:
+        virtual ~PlacementPolicy() = default;
+
+        //whole range [0, amountOfRAM) becomes free
+        virtual void reset(unsigned long long amountOfRAM) = 0;
+        //pick an address for size bytes and mark it used, false if nothing fits
+        virtual bool allocate(unsigned long long size, unsigned long long& address) = 0;
+        //give back a range returned by allocate
+        virtual void release(unsigned long long address, unsigned long long size) = 0;
+        //bytes an allocation of size takes out of RAM (its rounded up block for BUDDY)
+        virtual unsigned long long footprint(unsigned long long size) const { return size; }
+        //an allocation of size starts at a multiple of this (its block size for BUDDY)
+        virtual unsigned long long alignment(unsigned long long) const { return 1; }
+        //compaction: mark [address, address+size) used, a hole starts at address (false if the policy can't)
+        virtual bool claim(unsigned long long address, unsigned long long size) = 0;
+
+        virtual unsigned long long largestHole() const = 0;
+        virtual size_t holeCount() const = 0;
+        virtual const HoleHistogram& histogram() const = 0;
+};
+
+std::unique_ptr<PlacementPolicy> makePlacementPolicy(PlacementType type);
+
+class WorstFitPolicy : public PlacementPolicy {
+    public:
+        void reset(unsigned long long amountOfRAM) override;
+        bool allocate(unsigned long long size, unsigned long long& address) override;
+        void release(unsigned long long address, unsigned long long size) override;
+        bool claim(unsigned long long address, unsigned long long size) override;
+        unsigned long long largestHole() const override;
+        size_t holeCount() const override;
+        const HoleHistogram& histogram() const override;
+    private:
+        FreeHoleIndex holes_;
+};
+
+class BestFitPolicy : public PlacementPolicy {
+    public:
+        void reset(unsigned long long amountOfRAM) override;
+        bool allocate(unsigned long long size, unsigned long long& address) override;
+        void release(unsigned long long address, unsigned long long size) override;
+        bool claim(unsigned long long address, unsigned long long size) override;
+        unsigned long long largestHole() const override;
+        size_t holeCount() const override;
+        const HoleHistogram& histogram() const override;
+    private:
+        FreeHoleIndex holes_;
+};
+
+class FirstFitPolicy : public PlacementPolicy {
+    public:
+        void reset(unsigned long long amountOfRAM) override;
+        bool allocate(unsigned long long size, unsigned long long& address) override;
+        void release(unsigned long long address, unsigned long long size) override;
+        bool claim(unsigned long long address, unsigned long long size) override;
+        unsigned long long largestHole() const override;
+        size_t holeCount() const override;
+        const HoleHistogram& histogram() const override;
+    private:
+        HoleTree holes_;
+};
+
+class NextFitPolicy : public PlacementPolicy {
+    public:
+        void reset(unsigned long long amountOfRAM) override;
+        bool allocate(unsigned long long size, unsigned long long& address) override;
+        void release(unsigned long long address, unsigned long long size) override;
+        bool claim(unsigned long long address, unsigned long long size) override;
+        unsigned long long largestHole() const override;
+        size_t holeCount() const override;
+        const HoleHistogram& histogram() const override;
+    private:
+        HoleTree holes_;
+        unsigned long long rover_ {0};     //end of the last allocation
+};
+
+class BuddyPolicy : public PlacementPolicy {
+    public:
+        void reset(unsigned long long amountOfRAM) override;
+        bool allocate(unsigned long long size, unsigned long long& address) override;
+        void release(unsigned long long address, unsigned long long size) override;
+        bool claim(unsigned long long address, unsigned long long size) override;
+        unsigned long long footprint(unsigned long long size) const override;
+        unsigned long long alignment(unsigned long long size) const override;
+        unsigned long long largestHole() const override;
+        size_t holeCount() const override;
+        const HoleHistogram& histogram() const override;
+    private:
+        BuddyAllocator blocks_;
+};
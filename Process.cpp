@@ -8,7 +8,34 @@ Process::Process() :
     size_{0},
     priority_{-1},
     currentDisk_{-1},
-    parent_{nullptr} {
+    parent_{nullptr},
+    ready_{false},
+    slot_{-1},
+    diskNode_{-1},
+    diskMember_{-1},
+    waiting_{false},
+    memoryAddress_{0},
+    pageTable_{-1},
+    prevShare_{nullptr},
+    nextShare_{nullptr},
+    swap_{SwapState::RESIDENT},
+    swapStamp_{0},
+    rank_{-1},
+    sequence_{0},
+    prevReady_{nullptr},
+    nextReady_{nullptr},
+    prevMovable_{nullptr},
+    nextMovable_{nullptr},
+    level_{0},
+    ticksUsed_{0},
+    pass_{0},
+    core_{-1},
+    affinity_{-1},
+    lastRun_{0},
+    firstChild_{nullptr},
+    firstZombie_{nullptr},
+    prevSibling_{nullptr},
+    nextSibling_{nullptr} {
 }
 
 //parameter constructor
@@ -17,6 +44,81 @@ Process::Process(const int PID, unsigned long long size, int priority, Process*
     size_{size},
     priority_{priority},
     currentDisk_{-1},
-    parent_{parent} {
+    parent_{parent},
+    ready_{false},
+    slot_{-1},
+    diskNode_{-1},
+    diskMember_{-1},
+    waiting_{false},
+    memoryAddress_{0},
+    pageTable_{-1},
+    prevShare_{nullptr},
+    nextShare_{nullptr},
+    swap_{SwapState::RESIDENT},
+    swapStamp_{0},
+    rank_{priority},
+    sequence_{0},
+    prevReady_{nullptr},
+    nextReady_{nullptr},
+    prevMovable_{nullptr},
+    nextMovable_{nullptr},
+    level_{0},
+    ticksUsed_{0},
+    pass_{0},
+    core_{-1},
+    affinity_{-1},
+    lastRun_{0},
+    firstChild_{nullptr},
+    firstZombie_{nullptr},
+    prevSibling_{nullptr},
+    nextSibling_{nullptr} {
 }
 
+void Process::link(Process*& head, Process* child) {
+    child->prevSibling_ = nullptr;
+    child->nextSibling_ = head;
+    if (head != nullptr) {
+        head->prevSibling_ = child;
+    }
+    head = child;
+}
+
+void Process::unlink(Process*& head, Process* child) {
+    if (child->prevSibling_ != nullptr) {
+        child->prevSibling_->nextSibling_ = child->nextSibling_;
+    } else if (head == child) {
+        head = child->nextSibling_;
+    } else {
+        //not in this list
+        return;
+    }
+    if (child->nextSibling_ != nullptr) {
+        child->nextSibling_->prevSibling_ = child->prevSibling_;
+    }
+    child->prevSibling_ = nullptr;
+    child->nextSibling_ = nullptr;
+}
+
+void Process::addChild(Process* child) {
+    link(firstChild_, child);
+}
+
+void Process::removeChild(Process* child) {
+    unlink(firstChild_, child);
+}
+
+void Process::addZombie(Process* child) {
+    link(firstZombie_, child);
+}
+
+void Process::removeZombie(Process* child) {
+    unlink(firstZombie_, child);
+}
+
+bool Process::hasChildren() const {
+    return firstChild_ != nullptr;
+}
+
+bool Process::hasZombies() const {
+    return firstZombie_ != nullptr;
+}
@@ -1,8 +1,14 @@
 //Jacky Qiu
 //----------------------------------
 #pragma once
-#include <vector>
-#include <unordered_set>
+
+//Medium-term scheduling (see Swapper.h)
+enum class SwapState {
+    RESIDENT,
+    SWAPPING_OUT,       //memory released, write to the swap disk queued
+    SWAPPED,            //waits for memory
+    SWAPPING_IN         //memory reserved, read from the swap disk queued
+};
 
 class Process {
     public:
@@ -11,10 +17,50 @@ class Process {
         int priority_;
         int currentDisk_;
         Process* parent_;
+        bool ready_;            //in the ReadyQueue
+        int slot_;              //slot in ProcessTable, -1 if not in table
+        int diskNode_;          //node in its disk's DiskQueue, -1 if not queued
+        int diskMember_;        //merged follower / rider slot in that DiskQueue, -1 otherwise
+        bool waiting_;          //blocked in SimWait
+        unsigned long long memoryAddress_;
+        int pageTable_;         //paged memory only (see PagedMemory.h), -1 otherwise
+        Process* prevShare_;    //copy on write: processes sharing this memory region, nullptr = private
+        Process* nextShare_;
+        SwapState swap_;
+        unsigned long long swapStamp_;  //swap out order while SWAPPED
+
+        //scheduling state (see SchedulingPolicy.h)
+        long long rank_;                //ready queue key, higher runs first
+        unsigned long long sequence_;   //enqueue order, breaks rank ties
+        Process* prevReady_;            //neighbours in its ReadyQueue run list
+        Process* nextReady_;
+        Process* prevMovable_;          //same, among the queued processes without affinity
+        Process* nextMovable_;
+        int level_;                     //MLFQ level, 0 = top
+        int ticksUsed_;                 //of the current quantum
+        unsigned long long pass_;       //stride pass
+        int core_;                      //core it is queued / running on, or last ran on, -1 if never
+        int affinity_;                  //core it is pinned to, -1 for any
+        unsigned long long lastRun_;    //dispatch stamp, 0 if never dispatched
 
         Process ();
         Process (const int PID, unsigned long long size, int priority, Process* parent);
     
-        std::unordered_set<Process*> childrenProcesses_;
-        std::unordered_set<Process*> zombieProcesses_;
+        //children & zombies are intrusive sibling lists -> no allocation per fork
+        //a child is only ever in one of its parent's lists
+        Process* firstChild_;
+        Process* firstZombie_;
+        Process* prevSibling_;
+        Process* nextSibling_;
+
+        void addChild(Process* child);
+        void removeChild(Process* child);
+        void addZombie(Process* child);
+        void removeZombie(Process* child);
+        bool hasChildren() const;
+        bool hasZombies() const;
+
+    private:
+        static void link(Process*& head, Process* child);
+        static void unlink(Process*& head, Process* child);
 };
@@ -0,0 +1,84 @@
+//Jacky Qiu
+//----------------------------------
+#include "ProcessTable.h"
+
+ProcessTable::Slot& ProcessTable::slotAt(int slot) const {
+    return blocks_[slot / BLOCK_SIZE][slot % BLOCK_SIZE];
+}
+
+Process* ProcessTable::create(int PID, unsigned long long size, int priority, Process* parent) {
+    //reuse a freed slot before growing
+    int slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        //grab a new block when the last one is full
+        if (slotCount_ % BLOCK_SIZE == 0) {
+            blocks_.push_back(std::make_unique<Slot[]>(BLOCK_SIZE));
+        }
+        slot = slotCount_++;
+    }
+    Slot& entry = slotAt(slot);
+    entry.process = Process(PID, size, priority, parent);
+    entry.process.slot_ = slot;
+    entry.used = true;
+
+    if (PID >= static_cast<int>(slotOfPID_.size())) {
+        slotOfPID_.resize(PID + 1, -1);
+    }
+    slotOfPID_[PID] = slot;
+    ++count_;
+    return &entry.process;
+}
+
+void ProcessTable::erase(Process* ptr) {
+    if (ptr == nullptr || ptr->slot_ < 0) {
+        return;
+    }
+    erase(handleOf(ptr));
+}
+
+bool ProcessTable::erase(ProcessHandle handle) {
+    if (get(handle) == nullptr) {
+        return false;
+    }
+    Slot& entry = slotAt(handle.slot);
+    slotOfPID_[entry.process.PID_] = -1;
+    //old handles to this slot are now stale
+    entry.process = Process();
+    entry.used = false;
+    ++entry.generation;
+    freeSlots_.push_back(handle.slot);
+    --count_;
+    return true;
+}
+
+Process* ProcessTable::find(int PID) const {
+    if (PID < 0 || PID >= static_cast<int>(slotOfPID_.size()) || slotOfPID_[PID] < 0) {
+        return nullptr;
+    }
+    return &slotAt(slotOfPID_[PID]).process;
+}
+
+Process* ProcessTable::get(ProcessHandle handle) const {
+    if (handle.slot < 0 || handle.slot >= slotCount_) {
+        return nullptr;
+    }
+    Slot& entry = slotAt(handle.slot);
+    if (!entry.used || entry.generation != handle.generation) {
+        return nullptr;
+    }
+    return &entry.process;
+}
+
+ProcessHandle ProcessTable::handleOf(const Process* ptr) const {
+    if (ptr == nullptr || ptr->slot_ < 0 || ptr->slot_ >= slotCount_) {
+        return ProcessHandle{};
+    }
+    return ProcessHandle{ptr->slot_, slotAt(ptr->slot_).generation};
+}
+
+size_t ProcessTable::size() const {
+    return count_;
+}
@@ -0,0 +1,44 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Process.h"
+
+//Handle to a table slot, goes stale once the process is erased
+struct ProcessHandle {
+    int slot{-1};
+    unsigned int generation{0};
+};
+
+//Owns every Process object
+//Slots live in fixed blocks of BLOCK_SIZE that never move, so Process* kept in the
+//scheduler and disk queues stay valid and a fork only allocates once per block
+//PID -> slot index gives O(1) lookup, generation counters catch stale handles
+class ProcessTable {
+    public:
+        Process* create(int PID, unsigned long long size, int priority, Process* parent);
+        void erase(Process* ptr);
+        bool erase(ProcessHandle handle);
+
+        Process* find(int PID) const;
+        Process* get(ProcessHandle handle) const;
+        ProcessHandle handleOf(const Process* ptr) const;
+        size_t size() const;
+
+    private:
+        static constexpr int BLOCK_SIZE {1024};
+        struct Slot {
+            Process process;
+            unsigned int generation{0};
+            bool used{false};
+        };
+        std::vector<std::unique_ptr<Slot[]>> blocks_;
+        int slotCount_{0};                  //slots handed out so far
+        std::vector<int> freeSlots_;
+        std::vector<int> slotOfPID_;        //PID -> slot, -1 if not in table
+        size_t count_{0};
+
+        Slot& slotAt(int slot) const;
+};
@@ -0,0 +1,40 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+//splitmix64, fixed arithmetic so a seed gives the same stream on every platform
+//(std:: distributions are implementation defined)
+class Random {
+    public:
+        explicit Random(std::uint64_t seed) : state_{seed} {}
+
+        std::uint64_t next() {
+            std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        //[low, high]
+        unsigned long long uniform(unsigned long long low, unsigned long long high) {
+            if (high <= low) {
+                return low;
+            }
+            unsigned long long span = high - low + 1;
+            return span == 0 ? next() : low + next() % span;
+        }
+
+        //[0, 1)
+        double unit() {
+            return (next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        double exponential(double mean) {
+            return -mean * std::log1p(-unit());
+        }
+
+    private:
+        std::uint64_t state_;
+};
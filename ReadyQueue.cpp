@@ -0,0 +1,326 @@
+//Jacky Qiu
+//----------------------------------
+#include "ReadyQueue.h"
+
+ReadyQueue::RunLists::RunLists(Process* Process::* prevLink, Process* Process::* nextLink, int levels) :
+    prev{prevLink},
+    next{nextLink},
+    lists(levels),
+    bits((levels + 63) / 64, 0) {
+}
+
+void ReadyQueue::RunLists::link(Process* ptr, int level) {
+    Level& list = lists[level];
+    if (!list.first) {
+        bits[level / 64] |= 1ULL << (level % 64);
+        summary |= 1ULL << (level / 64);
+    }
+    //fresh sequences go straight to the back, only reserved ones walk
+    Process* after = list.last;
+    while (after && after->sequence_ > ptr->sequence_) {
+        after = after->*prev;
+    }
+    ptr->*prev = after;
+    ptr->*next = after ? after->*next : list.first;
+    (after ? after->*next : list.first) = ptr;
+    (ptr->*next ? ptr->*next->*prev : list.last) = ptr;
+}
+
+void ReadyQueue::RunLists::unlink(Process* ptr, int level) {
+    Level& list = lists[level];
+    (ptr->*prev ? ptr->*prev->*next : list.first) = ptr->*next;
+    (ptr->*next ? ptr->*next->*prev : list.last) = ptr->*prev;
+    ptr->*prev = nullptr;
+    ptr->*next = nullptr;
+    if (!list.first) {
+        bits[level / 64] &= ~(1ULL << (level % 64));
+        if (bits[level / 64] == 0) {
+            summary &= ~(1ULL << (level / 64));
+        }
+    }
+}
+
+int ReadyQueue::RunLists::highest() const {
+    if (summary == 0) {
+        return -1;
+    }
+    int word = 63 - __builtin_clzll(summary);
+    return word * 64 + 63 - __builtin_clzll(bits[word]);
+}
+
+int ReadyQueue::RunLists::nextBelow(int level) const {
+    int word = level / 64;
+    std::uint64_t lower = bits[word] & ((1ULL << (level % 64)) - 1);
+    if (lower) {
+        return word * 64 + 63 - __builtin_clzll(lower);
+    }
+    std::uint64_t lowerWords = summary & ((1ULL << word) - 1);
+    if (!lowerWords) {
+        return -1;
+    }
+    word = 63 - __builtin_clzll(lowerWords);
+    return word * 64 + 63 - __builtin_clzll(bits[word]);
+}
+
+void ReadyQueue::RunLists::clear() {
+    for (int word = 0; word < static_cast<int>(bits.size()); ++word) {
+        for (std::uint64_t set = bits[word]; set; set &= set - 1) {
+            lists[word * 64 + __builtin_ctzll(set)] = Level{};
+        }
+        bits[word] = 0;
+    }
+    summary = 0;
+}
+
+ReadyQueue::ReadyQueue(long long low, int levels) :
+    low_{low},
+    levels_{std::max(1, std::min(levels, MAX_LEVELS))},
+    all_{&Process::prevReady_, &Process::nextReady_, levels_},
+    movable_{&Process::prevMovable_, &Process::nextMovable_, levels_},
+    above_{Order::allocator_type{&pool_}},
+    below_{Order::allocator_type{&pool_}},
+    movableAbove_{Order::allocator_type{&pool_}},
+    movableBelow_{Order::allocator_type{&pool_}},
+    size_{0},
+    nextSequence_{0} {
+}
+
+bool ReadyQueue::inLevels(long long rank) const {
+    //unsigned difference is exact once rank >= low_
+    return rank >= low_ && static_cast<unsigned long long>(rank) - static_cast<unsigned long long>(low_) < static_cast<unsigned long long>(levels_);
+}
+
+int ReadyQueue::levelOf(long long rank) const {
+    return static_cast<int>(static_cast<unsigned long long>(rank) - static_cast<unsigned long long>(low_));
+}
+
+//affinity_ can't change while queued (SimOS takes a process out first)
+void ReadyQueue::insert(Process* ptr) {
+    bool movable = ptr->affinity_ < 0;
+    if (!inLevels(ptr->rank_)) {
+        bool below = ptr->rank_ < low_;
+        (below ? below_ : above_).insert(ptr);
+        if (movable) {
+            (below ? movableBelow_ : movableAbove_).insert(ptr);
+        }
+        return;
+    }
+    int level = levelOf(ptr->rank_);
+    all_.link(ptr, level);
+    if (movable) {
+        movable_.link(ptr, level);
+    }
+}
+
+void ReadyQueue::remove(Process* ptr) {
+    bool movable = ptr->affinity_ < 0;
+    if (!inLevels(ptr->rank_)) {
+        bool below = ptr->rank_ < low_;
+        (below ? below_ : above_).erase(ptr);
+        if (movable) {
+            (below ? movableBelow_ : movableAbove_).erase(ptr);
+        }
+        return;
+    }
+    int level = levelOf(ptr->rank_);
+    all_.unlink(ptr, level);
+    if (movable) {
+        movable_.unlink(ptr, level);
+    }
+}
+
+void ReadyQueue::clear() {
+    all_.clear();
+    movable_.clear();
+    above_.clear();
+    below_.clear();
+    movableAbove_.clear();
+    movableBelow_.clear();
+    size_ = 0;
+}
+
+void ReadyQueue::push(Process* ptr, unsigned long long sequence) {
+    //already queued -> nothing to do
+    if (contains(ptr)) {
+        return;
+    }
+    ptr->sequence_ = sequence == NEXT_SEQUENCE ? nextSequence_++ : sequence;
+    insert(ptr);
+    ptr->ready_ = true;
+    ++size_;
+}
+
+unsigned long long ReadyQueue::reserve() {
+    return nextSequence_++;
+}
+
+void ReadyQueue::pop() {
+    erase(top());
+}
+
+Process* ReadyQueue::top() const {
+    if (!above_.empty()) {
+        return *above_.begin();
+    }
+    int level = all_.highest();
+    if (level >= 0) {
+        return all_.lists[level].first;
+    }
+    if (!below_.empty()) {
+        return *below_.begin();
+    }
+    return nullptr;
+}
+
+Process* ReadyQueue::topMovable() const {
+    if (!movableAbove_.empty()) {
+        return *movableAbove_.begin();
+    }
+    int level = movable_.highest();
+    if (level >= 0) {
+        return movable_.lists[level].first;
+    }
+    if (!movableBelow_.empty()) {
+        return *movableBelow_.begin();
+    }
+    return nullptr;
+}
+
+void ReadyQueue::erase(Process* ptr) {
+    if (!contains(ptr)) {
+        return;
+    }
+    remove(ptr);
+    ptr->ready_ = false;
+    --size_;
+}
+
+void ReadyQueue::eraseBatch(const std::vector<Process*>& victims) {
+    //list members unlink in O(1), only tree members are worth batching
+    size_t inTrees = 0;
+    for (auto ptr : victims) {
+        if (!contains(ptr)) {
+            continue;
+        }
+        if (inLevels(ptr->rank_)) {
+            erase(ptr);
+        } else {
+            ++inTrees;
+        }
+    }
+    if (inTrees == 0) {
+        return;
+    }
+    //few victims -> individual O(log n) erases are cheaper than a rebuild
+    if (inTrees * 16 < above_.size() + below_.size()) {
+        for (auto ptr : victims) {
+            erase(ptr);
+        }
+        return;
+    }
+
+    //many victims -> unmark them and rebuild from the sorted survivors in O(n)
+    for (auto ptr : victims) {
+        ptr->ready_ = false;
+    }
+    size_ -= inTrees;
+    for (Order* tree : {&above_, &below_, &movableAbove_, &movableBelow_}) {
+        std::vector<Process*> survivors;
+        for (auto ptr : *tree) {
+            if (ptr->ready_) {
+                survivors.push_back(ptr);
+            }
+        }
+        tree->clear();
+        for (auto ptr : survivors) {
+            tree->insert(tree->end(), ptr);
+        }
+    }
+}
+
+void ReadyQueue::changePriority(Process* ptr, int priority) {
+    //key changes -> take it out while the priority moves
+    bool queued = contains(ptr);
+    erase(ptr);
+    ptr->priority_ = priority;
+    ptr->rank_ = priority;         //rank follows priority under the priority based policies
+    if (queued) {
+        push(ptr);
+    }
+}
+
+bool ReadyQueue::contains(const Process* ptr) const {
+    return ptr != nullptr && ptr->ready_;
+}
+
+bool ReadyQueue::empty() const {
+    return size_ == 0;
+}
+
+size_t ReadyQueue::size() const {
+    return size_;
+}
+
+ReadyQueue::const_iterator ReadyQueue::begin() const {
+    const_iterator it;
+    it.queue_ = this;
+    it.phase_ = const_iterator::ABOVE;
+    it.tree_ = above_.begin();
+    it.settle();
+    return it;
+}
+
+ReadyQueue::const_iterator ReadyQueue::end() const {
+    return const_iterator{};
+}
+
+void ReadyQueue::const_iterator::settle() {
+    if (phase_ == ABOVE) {
+        if (tree_ != queue_->above_.end()) {
+            current_ = *tree_;
+            return;
+        }
+        int level = queue_->all_.highest();
+        if (level >= 0) {
+            phase_ = LEVELS;
+            current_ = queue_->all_.lists[level].first;
+            return;
+        }
+        phase_ = BELOW;
+        tree_ = queue_->below_.begin();
+    }
+    if (phase_ == BELOW && tree_ != queue_->below_.end()) {
+        current_ = *tree_;
+        return;
+    }
+    phase_ = DONE;
+    current_ = nullptr;
+}
+
+ReadyQueue::const_iterator& ReadyQueue::const_iterator::operator++() {
+    switch (phase_) {
+        case ABOVE:
+        case BELOW:
+            ++tree_;
+            settle();
+            break;
+        case LEVELS: {
+            if (current_->nextReady_) {
+                current_ = current_->nextReady_;
+                break;
+            }
+            int level = queue_->all_.nextBelow(queue_->levelOf(current_->rank_));
+            if (level >= 0) {
+                current_ = queue_->all_.lists[level].first;
+                break;
+            }
+            phase_ = BELOW;
+            tree_ = queue_->below_.begin();
+            settle();
+            break;
+        }
+        case DONE:
+            break;
+    }
+    return *this;
+}
@@ -0,0 +1,140 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <vector>
+#include "Process.h"
+#include "NodePool.h"
+
+//Ready processes ordered by rank (highest first), FIFO among equal ranks
+//rank is the priority under the default policy (see SchedulingPolicy.h)
+//
+//Ranks in [low, low + levels) each get an intrusive FIFO list, a two level bitmap of
+//non-empty lists finds the top one with count-leading-zeros -> push/pop/top/erase are O(1)
+//Ranks outside the range fall back to pooled balanced trees ordered by (rank, enqueue order), O(log n)
+//Iteration walks above-range tree, lists, below-range tree -> GetReadyQueue / ViewReadyQueue never copy or pop
+//Processes without affinity are indexed a second time the same way -> the best one to steal is O(1) as well
+class ReadyQueue {
+    private:
+        struct Higher {
+            bool operator()(const Process* a, const Process* b) const {
+                if (a->rank_ != b->rank_) {
+                    return a->rank_ > b->rank_;
+                }
+                return a->sequence_ < b->sequence_;
+            }
+        };
+        using Order = std::set<Process*, Higher, PoolAllocator<Process*>>;
+        struct Level {
+            Process* first {nullptr};
+            Process* last {nullptr};
+        };
+        //one FIFO list per in-range rank, threaded through one pair of Process links, and the bitmap over them
+        struct RunLists {
+            Process* Process::* prev;
+            Process* Process::* next;
+            std::vector<Level> lists;
+            std::vector<std::uint64_t> bits;    //bit i of word w -> lists[w * 64 + i] non-empty
+            std::uint64_t summary {0};          //bit w -> bits[w] non-zero
+
+            RunLists(Process* Process::* prevLink, Process* Process::* nextLink, int levels);
+            void link(Process* ptr, int level);     //by sequence_, fresh ones go straight to the back
+            void unlink(Process* ptr, int level);
+            int highest() const;                    //-1 if every list is empty
+            int nextBelow(int level) const;         //-1 if none
+            void clear();
+        };
+
+    public:
+        static constexpr int MAX_LEVELS {64 * 64};      //one summary word over 64 bitmap words
+        static constexpr unsigned long long NEXT_SEQUENCE {~0ULL};
+
+        //ready processes in pop order
+        class const_iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = Process*;
+                using difference_type = std::ptrdiff_t;
+                using pointer = Process* const*;
+                using reference = Process* const&;
+
+                const_iterator() = default;
+                reference operator*() const { return current_; }
+                pointer operator->() const { return &current_; }
+                const_iterator& operator++();
+                const_iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+                bool operator==(const const_iterator& other) const { return current_ == other.current_; }
+                bool operator!=(const const_iterator& other) const { return current_ != other.current_; }
+
+            private:
+                friend class ReadyQueue;
+                enum Phase { ABOVE, LEVELS, BELOW, DONE };
+                const ReadyQueue* queue_ {nullptr};
+                Process* current_ {nullptr};
+                Phase phase_ {DONE};
+                Order::const_iterator tree_;
+                void settle();                  //move forward to the first process at or after this position
+        };
+
+        explicit ReadyQueue(long long low = 0, int levels = 1024);
+
+        //a reserved sequence puts ptr among its equal ranks where a push at reserve() time would have
+        void push(Process* ptr, unsigned long long sequence = NEXT_SEQUENCE);
+        unsigned long long reserve();
+        void pop();
+        Process* top() const;
+        Process* topMovable() const;            //best process without affinity, nullptr if none
+        void erase(Process* ptr);
+        //drop many processes at once (family tree kills)
+        void eraseBatch(const std::vector<Process*>& victims);
+        //moves ptr to the back of its new rank
+        void changePriority(Process* ptr, int priority);
+        //change the rank of every queued process at once (rekey(Process*) edits rank_) and re-sort
+        //enqueue order is kept
+        template <typename Rekey>
+        void rekeyAll(Rekey rekey);
+        bool contains(const Process* ptr) const;
+        bool empty() const;
+        size_t size() const;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    private:
+        long long low_;
+        int levels_;
+        RunLists all_;
+        RunLists movable_;                      //affinity_ < 0 only
+        NodePool pool_;
+        Order above_;
+        Order below_;
+        Order movableAbove_;
+        Order movableBelow_;
+        size_t size_;
+        unsigned long long nextSequence_;
+
+        bool inLevels(long long rank) const;
+        int levelOf(long long rank) const;
+        void insert(Process* ptr);              //link by (rank, sequence_), sequence_ already set
+        void remove(Process* ptr);
+        void clear();
+};
+
+template <typename Rekey>
+void ReadyQueue::rekeyAll(Rekey rekey) {
+    //keys change under the structures -> take everything out first, re-link in enqueue order
+    std::vector<Process*> queued (begin(), end());
+    clear();
+    std::sort(queued.begin(), queued.end(), [](const Process* a, const Process* b) {
+        return a->sequence_ < b->sequence_;
+    });
+    for (auto ptr : queued) {
+        rekey(ptr);
+        insert(ptr);
+        ptr->ready_ = true;
+    }
+    size_ = queued.size();
+}
@@ -0,0 +1,127 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include <climits>
+#include "SchedulingPolicy.h"
+
+//the OS process only runs when nothing else can
+constexpr long long OS_RANK {LLONG_MIN};
+static bool isOS(const Process* ptr) {
+    return ptr->PID_ == 1;
+}
+
+std::unique_ptr<SchedulingPolicy> makeSchedulingPolicy(const SchedulerSettings& settings) {
+    int quantum = std::max(1, settings.quantum);
+    switch (settings.type) {
+        case SchedulerType::ROUND_ROBIN:
+            return std::make_unique<RoundRobinPolicy>(quantum);
+        case SchedulerType::MLFQ:
+            return std::make_unique<FeedbackPolicy>(quantum, std::max(1, settings.levels), std::max(0, settings.boostInterval));
+        case SchedulerType::STRIDE:
+            return std::make_unique<StridePolicy>(quantum);
+        case SchedulerType::PRIORITY:
+        default:
+            return std::make_unique<PriorityPolicy>();
+    }
+}
+
+//PRIORITY
+void PriorityPolicy::admit(Process* ptr) {
+    ptr->rank_ = ptr->priority_;
+}
+
+bool PriorityPolicy::tick(Process*, ReadyQueue&, unsigned long long) {
+    return false;
+}
+
+//ROUND ROBIN
+RoundRobinPolicy::RoundRobinPolicy(int quantum) : quantum_{quantum} {}
+
+void RoundRobinPolicy::admit(Process* ptr) {
+    ptr->rank_ = ptr->priority_;
+    ptr->ticksUsed_ = 0;
+}
+
+bool RoundRobinPolicy::tick(Process* running, ReadyQueue&, unsigned long long) {
+    if (!running || ++running->ticksUsed_ < quantum_) {
+        return false;
+    }
+    running->ticksUsed_ = 0;
+    return true;
+}
+
+//MLFQ
+FeedbackPolicy::FeedbackPolicy(int quantum, int levels, int boostInterval) : 
+    quantum_{quantum},
+    levels_{levels},
+    boostInterval_{boostInterval} {
+}
+
+long long FeedbackPolicy::rankOf(const Process* ptr) const {
+    return isOS(ptr) ? OS_RANK : levels_ - ptr->level_;
+}
+
+void FeedbackPolicy::admit(Process* ptr) {
+    ptr->level_ = 0;
+    ptr->ticksUsed_ = 0;
+    ptr->rank_ = rankOf(ptr);
+}
+
+bool FeedbackPolicy::tick(Process* running, ReadyQueue& ready, unsigned long long now) {
+    //allotment is kept across disk reads -> yielding just before the quantum doesn't keep a process on top
+    bool expired = false;
+    if (running && ++running->ticksUsed_ >= (quantum_ << running->level_)) {
+        running->ticksUsed_ = 0;
+        running->level_ = std::min(running->level_ + 1, levels_ - 1);
+        running->rank_ = rankOf(running);
+        expired = true;
+    }
+
+    //aging: periodic boost of everyone so long running processes can't starve
+    if (boostInterval_ > 0 && now % boostInterval_ == 0) {
+        auto boost = [this](Process* ptr) {
+            ptr->level_ = 0;
+            ptr->ticksUsed_ = 0;
+            ptr->rank_ = rankOf(ptr);
+        };
+        ready.rekeyAll(boost);
+        if (running) {
+            boost(running);
+        }
+    }
+    return expired;
+}
+
+//STRIDE
+StridePolicy::StridePolicy(int quantum) : quantum_{quantum} {}
+
+unsigned long long StridePolicy::strideOf(const Process* ptr) {
+    return STRIDE1 / static_cast<unsigned long long>(std::max(1, ptr->priority_));
+}
+
+void StridePolicy::admit(Process* ptr) {
+    ptr->pass_ = virtualTime_;
+    ptr->ticksUsed_ = 0;
+    ptr->rank_ = isOS(ptr) ? OS_RANK : -static_cast<long long>(ptr->pass_);
+}
+
+void StridePolicy::wake(Process* ptr) {
+    //a process that slept doesn't get to bank the time it was away
+    ptr->pass_ = std::max(ptr->pass_, virtualTime_);
+    ptr->rank_ = -static_cast<long long>(ptr->pass_);
+}
+
+bool StridePolicy::tick(Process* running, ReadyQueue&, unsigned long long) {
+    if (!running) {
+        return false;
+    }
+    //charged every tick, rank only moves at the end of the quantum so it isn't preempted mid slice
+    virtualTime_ = std::max(virtualTime_, running->pass_);
+    running->pass_ += strideOf(running);
+    if (++running->ticksUsed_ < quantum_) {
+        return false;
+    }
+    running->ticksUsed_ = 0;
+    running->rank_ = -static_cast<long long>(running->pass_);
+    return true;
+}
@@ -0,0 +1,85 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <memory>
+#include "Process.h"
+#include "ReadyQueue.h"
+
+//CPU scheduling strategies
+enum class SchedulerType {
+    PRIORITY,       //default, strict preemptive priority, never time-slices
+    ROUND_ROBIN,    //strict priority, equal priorities take turns every quantum
+    MLFQ,           //multilevel feedback queue, priority ignored
+    STRIDE          //proportional share, priority = tickets
+};
+
+//Time only exists through SimOS::TimerTick, quanta are counted in ticks
+struct SchedulerSettings {
+    SchedulerType type{SchedulerType::PRIORITY};
+    int quantum{4};             //ticks, MLFQ level n gets quantum << n
+    int levels{3};              //MLFQ
+    int boostInterval{64};      //MLFQ aging: every boostInterval ticks everyone goes back to the top level, 0 = never
+    //ranks in [runQueueLow, runQueueLow + runQueueLevels) get O(1) FIFO run queues, the rest a tree (ReadyQueue.h)
+    //only a speed knob, the order is the same either way
+    long long runQueueLow{0};
+    int runQueueLevels{1024};
+};
+
+//Strategy object SimOS schedules through
+//The policy only decides each process' rank_, the ReadyQueue keeps them ordered -> O(1) per decision for
+//ranks inside the run queue range, O(log n) outside
+//A running process is preempted by a strictly higher rank, so every policy gets preemption for free
+class SchedulingPolicy {
+    public:
+        virtual ~SchedulingPolicy() = default;
+
+        //new process (NewProcess / fork child), set its starting rank
+        virtual void admit(Process* ptr) = 0;
+        //process comes back from a disk or SimWait
+        virtual void wake(Process* /*ptr*/) {}
+        //one clock tick on one core (now = ticks so far), running is nullptr while that core is idle
+        //returns true when running used up its quantum and should go behind equal ranks
+        virtual bool tick(Process* running, ReadyQueue& ready, unsigned long long now) = 0;
+};
+
+std::unique_ptr<SchedulingPolicy> makeSchedulingPolicy(const SchedulerSettings& settings);
+
+class PriorityPolicy : public SchedulingPolicy {
+    public:
+        void admit(Process* ptr) override;
+        bool tick(Process* running, ReadyQueue& ready, unsigned long long now) override;
+};
+
+class RoundRobinPolicy : public SchedulingPolicy {
+    public:
+        explicit RoundRobinPolicy(int quantum);
+        void admit(Process* ptr) override;
+        bool tick(Process* running, ReadyQueue& ready, unsigned long long now) override;
+    private:
+        int quantum_;
+};
+
+class FeedbackPolicy : public SchedulingPolicy {
+    public:
+        FeedbackPolicy(int quantum, int levels, int boostInterval);
+        void admit(Process* ptr) override;
+        bool tick(Process* running, ReadyQueue& ready, unsigned long long now) override;
+    private:
+        int quantum_;
+        int levels_;
+        int boostInterval_;
+        long long rankOf(const Process* ptr) const;
+};
+
+class StridePolicy : public SchedulingPolicy {
+    public:
+        explicit StridePolicy(int quantum);
+        void admit(Process* ptr) override;
+        void wake(Process* ptr) override;
+        bool tick(Process* running, ReadyQueue& ready, unsigned long long now) override;
+    private:
+        static constexpr unsigned long long STRIDE1 {1 << 20};
+        int quantum_;
+        unsigned long long virtualTime_ {0};     //pass of the last process that ran
+        static unsigned long long strideOf(const Process* ptr);
+};
@@ -0,0 +1,34 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstdint>
+
+//One public SimOS call, packed for SimOS::ApplyBatch
+enum class CommandType : std::uint8_t {
+    NEW_PROCESS,        //size, arg = priority
+    FORK,
+    EXIT,
+    WAIT,
+    DISK_READ,          //arg = disk number, fileId = index into the file name table, block, size = blocks read
+    DISK_COMPLETE,      //arg = disk number
+    GET_CPU,
+    TIMER_TICK,
+    ACCESS_MEMORY,      //size = address in the running process
+    WRITE_MEMORY        //size = address in the running process
+};
+
+struct SimCommand {
+    unsigned long long size{0};
+    int arg{0};
+    int fileId{0};
+    CommandType type{CommandType::GET_CPU};
+    std::uint16_t core{0};      //FORK / EXIT / WAIT / DISK_READ / GET_CPU / ACCESS_MEMORY / WRITE_MEMORY run on this core (fits in the padding)
+    unsigned long long block{0};    //DISK_READ first block
+};
+
+//Result slot per command:
+//NEW_PROCESS / FORK -> 1 on success, 0 on failure
+//ACCESS_MEMORY / WRITE_MEMORY -> 1 for a valid address (and room for a private copy), 0 otherwise
+//GET_CPU -> PID in the CPU
+//everything else -> 0
+using SimResult = int;
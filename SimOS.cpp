@@ -1,280 +1,783 @@
 //Jacky Qiu
 //----------------------------------
+#include <algorithm>
 #include "SimOS.h"
 
-SimOS::SimOS( int numberOfDisks, unsigned long long amountOfRAM, unsigned long long sizeOfOS) : 
+SimOS::SimOS( int numberOfDisks, unsigned long long amountOfRAM, unsigned long long sizeOfOS, const SimOSConfig& config) : 
     numberOfDisks_{numberOfDisks},
     amountOfRAM_{amountOfRAM},
     sizeOfOS_{sizeOfOS},
     OSadded_{false},
     trackPID_{0},
-    currentProcess{nullptr},
+    placement_{makePlacementPolicy(config.placement)},
     remainingRAM_{amountOfRAM},
+    fragmentationFailures_{0},
+    capacityFailures_{0},
+    compaction_{config.compaction},
+    copyOnWrite_{config.memory.copyOnWrite},
+    scheduling_{makeSchedulingPolicy(config.scheduler)},
+    nextCore_{0},
+    ticks_{0},
+    dispatches_{0},
+    deferSchedule_{false},
     currProcessInDisk{static_cast<size_t>(numberOfDisks)},
     waitingQueueInDisk{static_cast<size_t>(numberOfDisks)} {
+
+    int cores = std::max(1, config.cores);
+    for (int core = 0; core < cores; ++core) {
+        cores_.push_back(std::make_unique<Core>(config.scheduler.runQueueLow, config.scheduler.runQueueLevels));
+    }
+    idleCores_.assign((cores + 63) / 64, 0);
+    donorCores_.assign((cores + 63) / 64, 0);
+    for (int core = 0; core < cores; ++core) {
+        markCore(core);
+    }
+    for (int disk = 0; disk < numberOfDisks; ++disk) {
+        const auto& perDisk = config.disks.perDisk;
+        auto policy = static_cast<size_t>(disk) < perDisk.size() ? perDisk[disk] : config.disks.policy;
+        waitingQueueInDisk[disk].configure(policy, config.disks.deadline, config.disks.merge);
+    }
+    //paged memory swaps pages instead of whole processes
+    if (!config.memory.paged && config.swap.disk < numberOfDisks) {
+        swapper_.configure(config.swap);
+    }
+    //buddy blocks can't slide, pages don't need to
+    if (config.placement == PlacementType::BUDDY || config.memory.paged) {
+        compaction_.type = CompactionType::NONE;
+    }
+    if (config.memory.paged) {
+        auto memory = config.memory;
+        if (memory.swapDisk >= numberOfDisks) {
+            memory.swapDisk = -1;
+        }
+        paged_ = std::make_unique<PagedMemory>(memory, amountOfRAM, RAM_);
+    }
         
     OSadded_ = NewProcess(sizeOfOS_, 0);
 }
 
 bool SimOS::NewProcess( unsigned long long size, int priority ) {
     //OS case
-    if (OSadded_ == false && trackPID_ == 0 && size == sizeOfOS_ && fitInRAM(size)) {
-        Process newProcess (trackPID_, size, priority, nullptr);
-        processList.push_back(newProcess);
-        Scheduler.push({priority, &processList.back()});
-        updateCurrProcess();
+    unsigned long long address = 0;
+    if (OSadded_ == false && trackPID_ == 0 && size == sizeOfOS_ && fitInRAM(size, address)) {
+        auto newProcess = processTable_.create(trackPID_, size, priority, nullptr);
+        newProcess->memoryAddress_ = address;
+        newProcess->affinity_ = 0;              //idle process of core 0
+        scheduling_->admit(newProcess);
+        makeReady(newProcess, 0);
         return true;
     }
     
     //non OS case
-    if (OSadded_ && fitInRAM(size) && !RAM_.empty()) {
-        Process newProcess (trackPID_, size, priority, nullptr);
-        processList.push_back(newProcess);
-        Scheduler.push({priority, &processList.back()});
-        updateCurrProcess();
+    bool fits = OSadded_ && fitInRAM(size, address);
+    if (OSadded_ && !fits && swapOutFor(size, priority)) {
+        fits = fitInRAM(size, address);
+        if (fits) {
+            swapper_.savedAdmission();
+        }
+    }
+    if (fits && !RAM_.empty()) {
+        auto newProcess = processTable_.create(trackPID_, size, priority, nullptr);
+        newProcess->memoryAddress_ = address;
+        if (paged_) {
+            paged_->admit(newProcess);
+        }
+        scheduling_->admit(newProcess);
+        int home = nextCore_;
+        nextCore_ = (nextCore_ + 1) % static_cast<int>(cores_.size());
+        makeReady(newProcess, home);
         return true;
     }
     
+    if (OSadded_) {
+        placementFailed(size);
+    }
     return false;
 }
 
-bool SimOS::fitInRAM(unsigned long long size) {
+bool SimOS::fitInRAM(unsigned long long size, unsigned long long& address) {
+    //paged: frames are handed out by admit, only the commit limit decides here
+    if (paged_) {
+        bool fits = !OSadded_ && RAM_.empty() ? paged_->admitOS(trackPID_ + 1, size) : paged_->canAdmit(size);
+        if (fits) {
+            address = 0;
+            ++trackPID_;
+        }
+        return fits;
+    }
     //first process (OS) case
     if (!OSadded_ && RAM_.empty() && size <= amountOfRAM_) {
-        RAM_.push_back({0, sizeOfOS_, ++trackPID_});
-        remainingRAM_ -= size;
+        placement_->reset(amountOfRAM_);
+        if (!placement_->allocate(sizeOfOS_, address)) {
+            return false;
+        }
+        addToRAM(address, sizeOfOS_);
         return true;
     }
+    //placement policy picks the hole (worst fit by default)
+    if (allocateRAM(size, address)) {
+        addToRAM(address, size);
+        return true;
+    } 
+        
+    return false;
+}
+
+bool SimOS::allocateRAM(unsigned long long size, unsigned long long& address) {
     //process too large
-    if (size > remainingRAM_) {
+    if (placement_->footprint(size) > remainingRAM_) {
         return false;
-    } 
+    }
+    if (placement_->allocate(size, address)) {
+        return true;
+    }
+    //enough free bytes, just not in one hole
+    if (compaction_.type != CompactionType::NONE && compact(size) && placement_->allocate(size, address)) {
+        ++compactionStats_.savedAdmissions;
+        return true;
+    }
+    return false;
+}
 
-    int worstFit = findWorstFitIndex();
-    if (worstFit > 0) {
-        MemoryItem neighbor = RAM_[worstFit-1];
+//counted once the placement has finally failed (after compaction / swapping had their go)
+//against the policy's own free bytes, which include what BUDDY rounding wastes
+void SimOS::placementFailed(unsigned long long size) {
+    if (paged_ || placement_->footprint(size) > placement_->histogram().freeBytes) {
+        ++capacityFailures_;
+    } else {
+        ++fragmentationFailures_;
+    }
+}
 
-        //new address = neighborAddress + neighborSize
-        auto newAddress = neighbor.itemAddress + neighbor.itemSize;
-        MemoryItem newProcess {newAddress, size, ++trackPID_};
-        RAM_.insert(RAM_.begin() + worstFit, newProcess);
-        remainingRAM_ -= size;
+bool SimOS::compact(unsigned long long size) {
+    compactItems_.clear();
+    compactGaps_.clear();
+    unsigned long long end = 0;
+    for (auto item = RAM_.begin(); item != RAM_.end(); ++item) {
+        compactItems_.push_back(item);
+        compactGaps_.push_back(item->first - end);
+        end = item->first + item->second.itemSize;
+    }
+    compactGaps_.push_back(amountOfRAM_ - end);
+    auto itemSize = [this](size_t i) { return compactItems_[i]->second.itemSize; };
 
-        return true;
-    } 
-        
-    return false;
+    //items [first, last) slide down, the gaps first..last end up as one hole above them
+    size_t count = compactItems_.size();
+    size_t first = 0;
+    while (first < count && compactGaps_[first] == 0) {
+        ++first;
+    }
+    size_t last = count;
+    switch (compaction_.type) {
+        case CompactionType::NONE:
+            return false;
+        case CompactionType::FULL:
+            break;
+        case CompactionType::INCREMENTAL: {
+            unsigned long long moved = 0;
+            last = first;
+            while (last < count && (last == first || moved + itemSize(last) <= compaction_.budget)) {
+                moved += itemSize(last++);
+            }
+            break;
+        }
+        case CompactionType::MINIMAL: {
+            //window of gaps [k, m] with the items between them, for each k the smallest m whose gaps
+            //add up to size; m never goes back as k grows -> two pointers
+            unsigned long long free = compactGaps_[0];
+            unsigned long long cost = 0;
+            unsigned long long best = ~0ULL;
+            for (size_t k = 0, m = 0; k < count; ++k) {
+                while (free < size && m < count) {
+                    cost += itemSize(m++);
+                    free += compactGaps_[m];
+                }
+                if (free < size) {
+                    break;
+                }
+                if (cost < best) {
+                    best = cost;
+                    first = k;
+                    last = m;
+                }
+                free -= compactGaps_[k];
+                if (m == k) {
+                    free += compactGaps_[++m];
+                } else {
+                    cost -= itemSize(k);
+                }
+            }
+            if (best == ~0ULL) {
+                return false;
+            }
+            break;
+        }
+    }
+    if (first >= last) {
+        return false;
+    }
+
+    auto cursor = first == 0 ? 0 : compactItems_[first - 1]->first + itemSize(first - 1);
+    for (size_t i = first; i < last; ++i) {
+        auto bytes = itemSize(i);
+        moveItem(compactItems_[i], cursor);
+        compactionStats_.bytesMoved += bytes;
+        cursor += bytes;
+    }
+    ++compactionStats_.compactions;
+    compactionStats_.itemsMoved += last - first;
+    return true;
 }
 
-void SimOS::updateCurrProcess() {
-    if (!Scheduler.empty()) {
+//item slides down into the hole right below it
+void SimOS::moveItem(RAMMap::iterator item, unsigned long long address) {
+    auto bytes = item->second.itemSize;
+    if (bytes > 0) {
+        placement_->release(item->first, bytes);
+        placement_->claim(address, bytes);
+    }
+    //order doesn't change -> the node goes back where it was
+    auto next = std::next(item);
+    auto node = RAM_.extract(item);
+    node.key() = address;
+    node.mapped().itemAddress = address;
+    int PID = node.mapped().PID;
+    RAM_.insert(next, std::move(node));
 
-        auto [nextPriority, ptrNextProcess] = Scheduler.top();
+    //every process sharing the item points at it
+    auto ptr = processTable_.find(PID);
+    if (!ptr) {
+        return;
+    }
+    ptr->memoryAddress_ = address;
+    for (auto other = ptr->nextShare_; other && other != ptr; other = other->nextShare_) {
+        other->memoryAddress_ = address;
+    }
+}
 
-        //no current process
-        if (!currentProcess) {
-            currentProcess = ptrNextProcess;
-            Scheduler.pop();
+//other items can start at ptr's address: zero-size ones and, once ptr is swapped out, whatever took its place
+//at most one of them has bytes, a zero-size one is told apart by its owner -> end if ptr has nothing resident
+template <typename Map>
+static auto findItem(Map& ram, const Process* ptr) -> decltype(ram.begin()) {
+    auto range = ram.equal_range(ptr->memoryAddress_);
+    for (auto item = range.first; item != range.second; ++item) {
+        if (ptr->size_ > 0 && item->second.itemSize > 0) {
+            return item;
+        }
+        if (ptr->size_ == 0 && item->second.itemSize == 0) {
+            //listed under any of the sharers
+            auto owner = ptr;
+            do {
+                if (owner->PID_ == item->second.PID) {
+                    return item;
+                }
+                owner = owner->nextShare_;
+            } while (owner && owner != ptr);
+        }
+    }
+    return ram.end();
+}
+
+//plan first: walk candidates in victim policy order, joining each one's item with the free space and
+//planned items around it, until a run holds an aligned block of size (or compaction can join the free bytes)
+//Only the planned items overlapping that block are swapped out, a failed plan swaps nothing
+bool SimOS::swapOutFor(unsigned long long size, int priority) {
+    auto need = placement_->footprint(size);
+    if (!swapper_.enabled() || need > remainingRAM_ + swapper_.candidateBytes()) {
+        return false;
+    }
+    auto align = placement_->alignment(size);
+    bool compacts = compaction_.type == CompactionType::FULL || compaction_.type == CompactionType::MINIMAL;
+    unsigned long long freed = 0, low = 0, high = 0;
+    bool planned = false, joined = false;
+    swapPlan_.clear();
+    swapRuns_.clear();
+    swapper_.forEachVictim(priority, [&](Process* ptr) {
+        auto item = findItem(RAM_, ptr);
+        auto top = item->first + placement_->footprint(item->second.itemSize);
+        swapPlan_.push_back(ptr);
+        //free below reaches the previous item, free above the next one (zero-size items take no room)
+        auto prev = item;
+        while (prev != RAM_.begin() && (--prev)->second.itemSize == 0) {}
+        low = prev == item || prev->second.itemSize == 0 ? 0 : prev->first + placement_->footprint(prev->second.itemSize);
+        auto next = std::next(item);
+        while (next != RAM_.end() && next->second.itemSize == 0) {
+            ++next;
+        }
+        high = next == RAM_.end() ? amountOfRAM_ : next->first;
+        //a planned neighbour's run ends at this item / starts at its top
+        auto run = swapRuns_.upper_bound(item->first);
+        if (run != swapRuns_.begin() && std::prev(run)->second == item->first) {
+            low = std::prev(run)->first;
+            swapRuns_.erase(std::prev(run));
+        }
+        run = swapRuns_.find(top);
+        if (run != swapRuns_.end()) {
+            high = run->second;
+            swapRuns_.erase(run);
+        }
+        swapRuns_.emplace(low, high);
+        freed += placement_->footprint(ptr->size_);
+        auto start = (low + align - 1) / align * align;
+        joined = start + need <= high;
+        if (joined) {
+            low = start;
+            high = start + need;
+        }
+        planned = joined || (compacts && need <= remainingRAM_ + freed);
+        return planned;
+    });
+    if (!planned) {
+        return false;
+    }
+    //a joined run only needs the items overlapping the block
+    for (auto ptr : swapPlan_) {
+        if (!joined || (ptr->memoryAddress_ < high && ptr->memoryAddress_ + placement_->footprint(ptr->size_) > low)) {
+            swapOut(ptr);
+        }
+    }
+    return true;
+}
+
+void SimOS::swapOut(Process* ptr) {
+    dequeue(ptr);
+    removeFromRAM(ptr->PID_);
+    swapper_.swapOut(ptr);
+    queueRequest(swapper_.disk(), FileReadRequest{ptr->PID_, "swap", 0, 0}, ptr, false);
+}
+
+//oldest swapped process first, the others wait behind it
+void SimOS::swapIn() {
+    if (!swapper_.enabled()) {
+        return;
+    }
+    for (auto ptr = swapper_.next(); ptr != nullptr; ptr = swapper_.next()) {
+        unsigned long long address = 0;
+        if (placement_->footprint(ptr->size_) > remainingRAM_ || !placement_->allocate(ptr->size_, address)) {
             return;
         }
+        RAM_.emplace(address, MemoryItem{address, ptr->size_, ptr->PID_});
+        remainingRAM_ -= placement_->footprint(ptr->size_);
+        memoryStats_.privateBytes += ptr->size_;
+        ptr->memoryAddress_ = address;
+        swapper_.swapIn(ptr);
+        queueRequest(swapper_.disk(), FileReadRequest{ptr->PID_, "swap", 0, 0}, ptr, false);
+    }
+}
+
+SwapStats SimOS::GetSwapStats() const {
+    return swapper_.stats();
+}
+
+void SimOS::addToRAM(unsigned long long address, unsigned long long size) {
+    MemoryItem newProcess {address, size, ++trackPID_};
+    RAM_.emplace(address, newProcess);
+    //buddy blocks take more than asked for
+    remainingRAM_ -= placement_->footprint(size);
+    memoryStats_.privateBytes += size;
+}
+
+bool SimOS::validCore(int coreId) const {
+    return coreId >= 0 && coreId < static_cast<int>(cores_.size());
+}
+
+Process* SimOS::userProcessOn(int coreId) const {
+    if (!validCore(coreId)) {
+        return nullptr;
+    }
+    auto current = cores_[coreId]->current;
+    if (!current || current->PID_ == 1 || current->PID_ == NO_PROCESS) {
+        return nullptr;
+    }
+    return current;
+}
+
+//word by word scan from bit start (wrapping), at most cores / 64 words
+static int findBit(const std::vector<std::uint64_t>& bits, int start, int skip) {
+    int words = static_cast<int>(bits.size());
+    for (int step = 0; step <= words; ++step) {
+        int word = (start / 64 + step) % words;
+        std::uint64_t candidates = bits[word];
+        if (step == 0) {
+            candidates &= ~0ULL << (start % 64);
+        } else if (step == words) {
+            candidates &= (start % 64) ? ~(~0ULL << (start % 64)) : 0;
+        }
+        if (skip / 64 == word) {
+            candidates &= ~(1ULL << (skip % 64));
+        }
+        if (candidates) {
+            return word * 64 + __builtin_ctzll(candidates);
+        }
+    }
+    return -1;
+}
+
+static void setBit(std::vector<std::uint64_t>& bits, int index, bool value) {
+    if (value) {
+        bits[index / 64] |= 1ULL << (index % 64);
+    } else {
+        bits[index / 64] &= ~(1ULL << (index % 64));
+    }
+}
+
+void SimOS::markCore(int coreId) {
+    Core& core = *cores_[coreId];
+    setBit(idleCores_, coreId, !core.current || core.current->PID_ == 1);
+    setBit(donorCores_, coreId, core.movable > 0);
+}
+
+void SimOS::enqueue(int coreId, Process* ptr, unsigned long long sequence) {
+    Core& core = *cores_[coreId];
+    core.ready.push(ptr, sequence);
+    ptr->core_ = coreId;
+    if (ptr->affinity_ < 0) {
+        ++core.movable;
+    }
+    if (swapper_.enabled() && ptr->PID_ > 1 && !ptr->nextShare_) {
+        swapper_.track(ptr);
+    }
+    markCore(coreId);
+}
+
+void SimOS::dequeue(Process* ptr) {
+    if (!ptr->ready_) {
+        return;
+    }
+    Core& core = *cores_[ptr->core_];
+    core.ready.erase(ptr);
+    if (ptr->affinity_ < 0) {
+        --core.movable;
+    }
+    if (swapper_.enabled()) {
+        swapper_.untrack(ptr);
+    }
+    markCore(ptr->core_);
+}
+
+Process* SimOS::steal(int thief) {
+    int donor = findBit(donorCores_, (thief + 1) % static_cast<int>(cores_.size()), thief);
+    if (donor < 0) {
+        return nullptr;
+    }
+    //a deferred preemption is already the donor's running process, it must not be given away too
+    flushCore(donor);
+    //best ranked process the donor is allowed to give away
+    auto ptr = cores_[donor]->ready.topMovable();
+    if (ptr) {
+        dequeue(ptr);
+    }
+    return ptr;
+}
+
+void SimOS::schedule(int coreId) {
+    Core& core = *cores_[coreId];
+    bool idle = !core.current || core.current->PID_ == 1;
+    if (idle && (core.ready.empty() || core.ready.top()->PID_ == 1) && cores_.size() > 1) {
+        //ran dry -> take work from a core with a backlog
+        if (auto stolen = steal(coreId)) {
+            enqueue(coreId, stolen);
+        }
+    }
 
-        //next process GREATER THAN priority of current case
-        if (nextPriority > currentProcess->priority_) {
-            Scheduler.pop();
+    if (!core.ready.empty()) {
+
+        auto ptrNextProcess = core.ready.top();
+        auto nextRank = ptrNextProcess->rank_;
+
+        //no current process
+        if (!core.current) {
+            dequeue(ptrNextProcess);
+            core.current = ptrNextProcess;
+            ptrNextProcess->lastRun_ = ++dispatches_;
+        }
+        //next process GREATER THAN rank (priority under the default policy) of current case
+        else if (nextRank > core.current->rank_) {
+            dequeue(ptrNextProcess);
             //reschedule current process if real process
-            if (currentProcess->PID_ != NO_PROCESS) {
-                Scheduler.push({currentProcess->priority_, currentProcess});
+            if (core.current->PID_ != NO_PROCESS) {
+                enqueue(coreId, core.current);
             }
-            currentProcess = ptrNextProcess;
-            return;
+            core.current = ptrNextProcess;
+            ptrNextProcess->lastRun_ = ++dispatches_;
         }
         //next process LESS THAN or EQUAL TO priority of current case -> do nothing
     }
+    markCore(coreId);
 }
 
-bool SimOS::parentFork() {
-    if (currentProcess->PID_ == 1 || currentProcess->PID_ == NO_PROCESS || !currentProcess) {
-        return false;
+void SimOS::makeReady(Process* ptr, int preferredCore) {
+    int target = ptr->affinity_ >= 0 ? ptr->affinity_ : preferredCore;
+    if (!validCore(target)) {
+        target = 0;
     }
-    auto parentProcess = currentProcess;
-    bool childFitsInRAM = fitInRAM(parentProcess->size_);
-    if (childFitsInRAM) {
-        //create child process with parent's PID
-        Process childProcess (trackPID_, parentProcess->size_, parentProcess->priority_, parentProcess);
-        processList.push_back(childProcess);
-        Scheduler.push({childProcess.priority_, &processList.back()});
-        parentProcess->childrenProcesses_.insert(&processList.back());
-        return true;
+    //unpinned work goes to an idle core when its own core is busy
+    if (ptr->affinity_ < 0 && cores_.size() > 1 && !((idleCores_[target / 64] >> (target % 64)) & 1)) {
+        int idle = findBit(idleCores_, target, target);
+        if (idle >= 0) {
+            target = idle;
+        }
+    }
+    enqueue(target, ptr);
+    if (!deferWake(target, ptr)) {
+        schedule(target);
     }
-    return false;
 }
 
-int SimOS::findWorstFitIndex() {
-    unsigned long long maxHoleSize = 0;
-    int worstFitIndex = 0;
-    //RAM will never be empty since OS always running assuming it was successfully added to RAM
-    for (int i = 1; i < RAM_.size(); ++i) {
-        auto prevMemItem = RAM_[i-1];
-        auto currMemItem = RAM_[i];
-        auto prevAddrEnd = prevMemItem.itemAddress + prevMemItem.itemSize;
-
-        //contiguous process case (no hole)
-        if (prevAddrEnd == currMemItem.itemAddress) {
-            continue;
-        //non-contiguous process case
+//same outcome as scheduling after every wake: only a rank above whoever would be running preempts,
+//the preempted process keeps the place it would have taken in the queue at that moment
+//Idle cores dispatch at once so the idle bitmap stays what per-call scheduling would see
+bool SimOS::deferWake(int coreId, Process* ptr) {
+    Core& core = *cores_[coreId];
+    if (!deferSchedule_ || !core.current || core.current->PID_ == 1 || core.current->PID_ == NO_PROCESS) {
+        return false;
+    }
+    auto running = core.pendingTop ? core.pendingTop : core.current;
+    if (ptr->rank_ > running->rank_) {
+        if (core.pendingTop) {
+            //would have run until now -> back of its rank
+            dequeue(core.pendingTop);
+            enqueue(coreId, core.pendingTop);
         } else {
-            auto holeSize = currMemItem.itemAddress - prevAddrEnd;
-            if (holeSize > maxHoleSize) {
-                maxHoleSize = holeSize;
-                worstFitIndex = i;
-            }
+            core.pendingSequence = core.ready.reserve();
+            pendingCores_.push_back(coreId);
         }
+        core.pendingTop = ptr;
     }
-    //check hole (from last process) TO (end of RAM)
-    auto lastMemItem = RAM_.back();
-    auto lastAddrEnd = lastMemItem.itemAddress + lastMemItem.itemSize;
-    auto lastHole = amountOfRAM_ - lastAddrEnd;
-    
-    if (lastHole > maxHoleSize) {
-        return RAM_.size();
+    return true;
+}
+
+void SimOS::flushSchedule() {
+    for (int coreId : pendingCores_) {
+        flushCore(coreId);
     }
+    pendingCores_.clear();
+}
 
-    //ELSE (lastHole <= maxHoleSize) THEN use earlier index
-    return worstFitIndex;
+void SimOS::flushCore(int coreId) {
+    Core& core = *cores_[coreId];
+    auto next = core.pendingTop;
+    if (!next) {
+        return;
+    }
+    dequeue(next);
+    enqueue(coreId, core.current, core.pendingSequence);
+    core.current = next;
+    next->lastRun_ = ++dispatches_;
+    core.pendingTop = nullptr;
+    markCore(coreId);
 }
 
-bool SimOS::SimFork() {
-    if (OSadded_ == false || currentProcess->PID_ == 1 || currentProcess->PID_ == NO_PROCESS || !currentProcess) {
+bool SimOS::parentFork(int coreId) {
+    auto parentProcess = userProcessOn(coreId);
+    if (!parentProcess) {
         return false;
     }
-    updateCurrProcess();
-    bool childCreated = parentFork();
-    if (childCreated) {
-        updateCurrProcess();
+    unsigned long long address = 0;
+    bool childFitsInRAM;
+    if (copyOnWrite_) {
+        //child shares the parent's memory, nothing to place
+        childFitsInRAM = !paged_ || paged_->canFork(parentProcess);
+        address = parentProcess->memoryAddress_;
+        trackPID_ += childFitsInRAM;
+    } else {
+        childFitsInRAM = fitInRAM(parentProcess->size_, address);
+        if (!childFitsInRAM) {
+            placementFailed(parentProcess->size_);
+        }
+    }
+    if (childFitsInRAM) {
+        //create child process with parent's PID
+        auto childProcess = processTable_.create(trackPID_, parentProcess->size_, parentProcess->priority_, parentProcess);
+        childProcess->memoryAddress_ = address;
+        if (copyOnWrite_ && paged_) {
+            paged_->fork(parentProcess, childProcess);
+        } else if (copyOnWrite_) {
+            shareRegion(parentProcess, childProcess);
+        } else if (paged_) {
+            paged_->admit(childProcess);
+        }
+        parentProcess->addChild(childProcess);
+        scheduling_->admit(childProcess);
+        makeReady(childProcess, coreId);
         return true;
     }
     return false;
 }
 
+bool SimOS::SimFork() {
+    return SimFork(0);
+}
+
+bool SimOS::SimFork(int coreId) {
+    if (OSadded_ == false || !userProcessOn(coreId)) {
+        return false;
+    }
+    schedule(coreId);
+    return parentFork(coreId);
+}
+
 void SimOS::killFamilyTree(Process* ptr) {
     //base case
     if (ptr == nullptr) {
         return;
     }
 
-    for (auto childrenPtrs : (ptr->childrenProcesses_)) {
-        //keep traversing down family tree
-        killFamilyTree(childrenPtrs);
-        //kill children & grandchildren
-        removeFromRAM(childrenPtrs->PID_);
-        removeFromScheduler(childrenPtrs);
-        removeFromAnyDisk(childrenPtrs);
-        removeFromProcessList(childrenPtrs);
+    //collect the whole family first (children, zombies & their families), no recursion
+    victims_.clear();
+    victims_.push_back(ptr);
+    for (size_t i = 0; i < victims_.size(); ++i) {
+        auto member = victims_[i];
+        for (auto child = member->firstChild_; child != nullptr; child = child->nextSibling_) {
+            victims_.push_back(child);
+        }
+        for (auto zombie = member->firstZombie_; zombie != nullptr; zombie = zombie->nextSibling_) {
+            victims_.push_back(zombie);
+        }
+    }
+
+    //then one pass per structure
+    for (auto victim : victims_) {
+        removeFromRAM(victim->PID_);
+    }
+    if (cores_.size() == 1) {
+        Core& core = *cores_[0];
+        for (auto victim : victims_) {
+            core.movable -= victim->ready_ && victim->affinity_ < 0;
+        }
+        core.ready.eraseBatch(victims_);
+        markCore(0);
+    } else {
+        for (auto victim : victims_) {
+            dequeue(victim);
+        }
+    }
+    removeFromDisks(victims_);
+
+    //family members running on other cores lose their CPU
+    vacated_.clear();
+    for (auto victim : victims_) {
+        if (victim->core_ >= 0 && cores_[victim->core_]->current == victim) {
+            cores_[victim->core_]->current = nullptr;
+            vacated_.push_back(victim->core_);
+        }
+    }
+    for (auto victim : victims_) {
+        removeFromProcessList(victim);
+    }
+    victims_.clear();
+    for (int coreId : vacated_) {
+        schedule(coreId);
     }
-    ptr->childrenProcesses_.clear();
 }
 
 void SimOS::SimExit() {
-    if (OSadded_ == false || currentProcess->PID_ == 1 || currentProcess->PID_ == NO_PROCESS || !currentProcess) {
+    SimExit(0);
+}
+
+void SimOS::SimExit(int coreId) {
+    if (OSadded_ == false || !userProcessOn(coreId)) {
         return;
     }
-    updateCurrProcess();
-    bool isChild = currentProcess->parent_ != nullptr;
-    bool isParent = !currentProcess->childrenProcesses_.empty();
+    exitProcess(coreId);
+    //freed memory may let swapped processes back in
+    swapIn();
+}
+
+void SimOS::exitProcess(int coreId) {
+    schedule(coreId);
+    Core& core = *cores_[coreId];
+    auto current = core.current;
+    bool isChild = current->parent_ != nullptr;
+    bool isParent = current->hasChildren();
     if (isChild) {
-        auto child = currentProcess;
+        auto child = current;
         auto parent = child->parent_;
-        bool waitingParentExists = waitingParents.count(parent);
+        bool waitingParentExists = parent->waiting_;
         if (waitingParentExists) {
             //waiting parent + child exit case
  
-            parent->childrenProcesses_.erase(child);
+            parent->removeChild(child);
             //remove child process object and clean up
             removeFromRAM(child->PID_);
-            removeFromScheduler(child);
+            dequeue(child);
             removeFromAnyDisk(child);
             removeFromProcessList(child);
+            core.current = nullptr;
 
             //parent gets out of waiting
-            waitingParents.erase(parent);
-            Scheduler.push({parent->priority_, parent});
-            
-            currentProcess = nullptr;
-            updateCurrProcess();
+            parent->waiting_ = false;
+            scheduling_->wake(parent);
+            makeReady(parent, parent->core_);
+            schedule(coreId);
             return;
         } else if (!waitingParentExists) {
             //non-waiting parent + child exit case (ZOMBIE)
             
             //create zombie process
-            parent->childrenProcesses_.erase(child);
-            parent->zombieProcesses_.insert(child);
+            parent->removeChild(child);
+            parent->addZombie(child);
             //remove child process from RAM and start next process
             removeFromRAM(child->PID_);
-            removeFromScheduler(child);
+            dequeue(child);
             removeFromAnyDisk(child);
             
-            currentProcess = nullptr;
-            updateCurrProcess();
+            core.current = nullptr;
+            schedule(coreId);
             return;
         }
     } else if (isParent) {
-        //parent exit -> kill all children & grandchildren then exit (ORPHAN)
-        auto parent = currentProcess;
-        killFamilyTree(parent);
-        
-        //remove parent
-        removeFromRAM(parent->PID_);
-        removeFromScheduler(parent);
-        removeFromAnyDisk(parent);
-        removeFromProcessList(parent);
-        waitingParents.erase(parent);
-        
-        currentProcess = nullptr;
-        updateCurrProcess();
+        //parent exit -> kill parent, all children & grandchildren (ORPHAN)
+        //(vacates every core the family was running on, this one included)
+        killFamilyTree(current);
+        schedule(coreId);
         return;
     } else {
         //non-parent , non-child case
-        removeFromRAM(currentProcess->PID_);
-        removeFromScheduler(currentProcess);
-        removeFromAnyDisk(currentProcess);
-        removeFromProcessList(currentProcess);
+        removeFromRAM(current->PID_);
+        dequeue(current);
+        removeFromAnyDisk(current);
+        removeFromProcessList(current);
         
-        currentProcess = nullptr;
-        updateCurrProcess();
+        core.current = nullptr;
+        schedule(coreId);
     }
 }
 
-void SimOS::removeFromScheduler(Process* ptr) {
-    std::priority_queue<std::tuple<int, Process*>> newScheduler;
-
-    while (!Scheduler.empty()) {
-        auto [nextPriority, ptrNextProcess] = Scheduler.top();
-        if (ptrNextProcess != ptr) {
-            newScheduler.push({nextPriority, ptrNextProcess});
-        }
-        Scheduler.pop();
-    }
-    Scheduler = std::move(newScheduler);   
-}
-
 void SimOS::removeFromProcessList(Process* ptr) {
-    for (auto listptr = processList.begin(); listptr != processList.end(); ++listptr) {
-        Process* addressOfProcess = &(*listptr);
-        if (addressOfProcess == ptr) { 
-            processList.erase(listptr);
-            return;
-        }
+    if (swapper_.enabled()) {
+        swapper_.forget(ptr);
     }
+    //slot index lives in the process -> O(1)
+    processTable_.erase(ptr);
 }
 
 void SimOS::removeFromRAM(int PID) {
-    for (auto ptr = RAM_.begin(); ptr != RAM_.end(); ++ptr) {
-        if (ptr->PID == PID) {
-            remainingRAM_ += ptr->itemSize;
-            RAM_.erase(ptr);
-            return;
+    auto ptr = processTable_.find(PID);
+    if (ptr == nullptr) {
+        return;
+    }
+    if (paged_) {
+        paged_->release(ptr);
+        return;
+    }
+    auto memItem = findItem(RAM_, ptr);
+    if (ptr->nextShare_) {
+        //still in use by the other sharers, listed under one of them if it was under ptr
+        auto other = unshareRegion(ptr);
+        if (memItem != RAM_.end() && memItem->second.PID == PID) {
+            memItem->second.PID = other->PID_;
         }
+        return;
     }
+    if (memItem == RAM_.end() || memItem->second.PID != PID) {
+        return;
+    }
+    remainingRAM_ += placement_->footprint(memItem->second.itemSize);
+    memoryStats_.privateBytes -= memItem->second.itemSize;
+    //hole merges with free neighbors
+    placement_->release(memItem->second.itemAddress, memItem->second.itemSize);
+    RAM_.erase(memItem);
 }
 
 void SimOS::removeFromAnyDisk(Process* ptr) {
@@ -296,14 +799,34 @@ void SimOS::removeFromDisk(Process* ptr) {
     //get ptr of process using current disk
     auto currProcInDisk = std::get<1>(currProcessInDisk[currDisk]);
     if (ptr == currProcInDisk) {
+        //merged job keeps going for its riders
+        if (waitingQueueInDisk[currDisk].promoteRider(currProcessInDisk[currDisk])) {
+            return;
+        }
         currProcessInDisk[currDisk] = {FileReadRequest{}, nullptr};
         
         //load next process if non-empty queue
-        if (!waitingQueueInDisk[currDisk].empty()) {
-            auto [nextRequest, nextProcessPtr] = waitingQueueInDisk[currDisk].front();
-            waitingQueueInDisk[currDisk].pop();
-            currProcessInDisk[currDisk] = {nextRequest, nextProcessPtr};
-        }
+        loadNextRequest(currDisk);
+    } else {
+        waitingQueueInDisk[currDisk].dropRider(ptr);
+    }
+}
+
+void SimOS::loadNextRequest(int diskNumber) {
+    if (!waitingQueueInDisk[diskNumber].empty()) {
+        //policy picks the request, the queue moves the head
+        currProcessInDisk[diskNumber] = waitingQueueInDisk[diskNumber].take();
+    }
+}
+
+void SimOS::removeFromDisks(const std::vector<Process*>& victims) {
+    //drop queued victims first so a freed disk never loads another victim
+    for (auto ptr : victims) {
+        removeFromDiskQueue(ptr);
+    }
+    for (auto ptr : victims) {
+        removeFromDisk(ptr);
+        ptr->currentDisk_ = -1;
     }
 }
 
@@ -317,95 +840,317 @@ void SimOS::removeFromDiskQueue(Process* ptr) {
         return;
     }
 
-    std::queue<std::tuple<FileReadRequest,Process*>>* ptrToWaitingQ = &waitingQueueInDisk[currDisk];
-    std::queue<std::tuple<FileReadRequest,Process*>> replacementQueue;
-    while (!ptrToWaitingQ->empty()) {
-        auto [request, ptrProcess] = ptrToWaitingQ->front();
-        ptrToWaitingQ->pop();
-        if (ptrProcess != ptr) {
-            replacementQueue.push({request, ptrProcess});
-        }
-    }
-    //replace waiting queue 
-    waitingQueueInDisk[currDisk] = replacementQueue;
+    //node index lives in the process -> O(1)
+    waitingQueueInDisk[currDisk].erase(ptr);
 }
 
 void SimOS::SimWait() {
+    SimWait(0);
+}
+
+void SimOS::SimWait(int coreId) {
     //if not parent or invalid process, do nothing
-    if (OSadded_ == false || currentProcess->PID_ == 1 || currentProcess->PID_ == NO_PROCESS || !currentProcess || currentProcess->childrenProcesses_.empty()) {
+    auto parent = OSadded_ ? userProcessOn(coreId) : nullptr;
+    if (!parent || !parent->hasChildren()) {
         return;
     } 
 
-    auto parent = currentProcess;
-    if (parent->zombieProcesses_.empty()) {
+    if (!parent->hasZombies()) {
         //no zombie processes case -> parent waits
-        waitingParents.insert(parent);
-        currentProcess = nullptr;
-        updateCurrProcess();
+        parent->waiting_ = true;
+        cores_[coreId]->current = nullptr;
+        schedule(coreId);
     } else {
         //zombies exist case
-        auto zombieSet = parent->zombieProcesses_;
-        Process* zombieProcess = *(zombieSet.begin());
+        Process* zombieProcess = parent->firstZombie_;
         //clean up zombie process remanents
-        parent->zombieProcesses_.erase(zombieProcess);
+        parent->removeZombie(zombieProcess);
         removeFromProcessList(zombieProcess);
     }
 }
 
 int SimOS::GetCPU() {
-    if (OSadded_ == false) {
+    return GetCPU(0);
+}
+
+int SimOS::GetCPU(int coreId) {
+    if (OSadded_ == false || !validCore(coreId)) {
         return NO_PROCESS;
     }
 
-    updateCurrProcess();
-    return currentProcess->PID_;
+    schedule(coreId);
+    auto current = cores_[coreId]->current;
+    return current ? current->PID_ : NO_PROCESS;
 }
 
-std::vector<int> SimOS::GetReadyQueue() {
-    if (OSadded_ == false || Scheduler.empty()) {
-        return {};
+int SimOS::GetCoreCount() const {
+    return static_cast<int>(cores_.size());
+}
+
+bool SimOS::SetAffinity(int PID, int coreId) {
+    if (OSadded_ == false || PID == 1 || coreId < -1 || coreId >= static_cast<int>(cores_.size())) {
+        return false;
     }
-    
-    auto schedulerCopy = Scheduler;
-    std::vector<int> readyQ (schedulerCopy.size()); 
-    int i = 0;
-    while (!schedulerCopy.empty()) {
-        auto nextProcess = std::get<1>(schedulerCopy.top());
-        readyQ[i++] = nextProcess->PID_;
+    auto ptr = processTable_.find(PID);
+    if (!ptr) {
+        return false;
+    }
+    if (ptr->ready_) {
+        //queued somewhere else -> move it
+        dequeue(ptr);
+        ptr->affinity_ = coreId;
+        makeReady(ptr, ptr->core_);
+    } else if (coreId >= 0 && ptr->core_ >= 0 && ptr->core_ != coreId && cores_[ptr->core_]->current == ptr) {
+        //running on the wrong core -> migrate now
+        int from = ptr->core_;
+        cores_[from]->current = nullptr;
+        ptr->affinity_ = coreId;
+        makeReady(ptr, coreId);
+        schedule(from);
+    } else {
+        //waiting / on a disk / running where it belongs -> applies on its next wake up
+        ptr->affinity_ = coreId;
+    }
+    return true;
+}
+
+void SimOS::TimerTick() {
+    if (OSadded_ == false) {
+        return;
+    }
+    ++ticks_;
+    for (int coreId = 0; coreId < static_cast<int>(cores_.size()); ++coreId) {
+        Core& core = *cores_[coreId];
+        schedule(coreId);
+        auto running = userProcessOn(coreId);
+        bool expired = scheduling_->tick(running, core.ready, ticks_);
+
+        //quantum used up -> go behind everyone ready with the same (or a higher) rank
+        if (expired && !core.ready.empty() && core.ready.top()->rank_ >= running->rank_) {
+            auto next = core.ready.top();
+            dequeue(next);
+            enqueue(coreId, running);
+            core.current = next;
+            next->lastRun_ = ++dispatches_;
+        }
+        //ranks may have moved (MLFQ boost)
+        schedule(coreId);
+    }
+}
+
+std::vector<int> SimOS::GetReadyQueue() {
+    return GetReadyQueue(0);
+}
+
+std::vector<int> SimOS::GetReadyQueue(int coreId) {
+    auto view = ViewReadyQueue(coreId);
+    return std::vector<int> (view.begin(), view.end());
+}
+
+ReadyQueueView SimOS::ViewReadyQueue() const {
+    return ViewReadyQueue(0);
+}
 
-        schedulerCopy.pop();
+ReadyQueueView SimOS::ViewReadyQueue(int coreId) const {
+    //ready queue is always sorted -> walk it in place
+    if (OSadded_ == false || !validCore(coreId)) {
+        return ReadyQueueView(ReadyQueue::const_iterator{}, ReadyQueue::const_iterator{}, 0);
     }
-    return readyQ;
+    auto& ready = cores_[coreId]->ready;
+    return ReadyQueueView(ready.begin(), ready.end(), ready.size());
 }
 
 MemoryUse SimOS::GetMemory() {
+    auto view = ViewMemory();
+    return MemoryUse (view.begin(), view.end());
+}
+
+MemoryView SimOS::ViewMemory() const {
     if (OSadded_ == false) {
-        return {};
+        return MemoryView(RAM_.end(), RAM_.end(), 0);
+    }
+    return MemoryView(RAM_.begin(), RAM_.end(), RAM_.size());
+}
+
+bool SimOS::AccessMemory( unsigned long long address ) {
+    return AccessMemory(0, address);
+}
+
+bool SimOS::AccessMemory( int coreId, unsigned long long address ) {
+    return touchMemory(coreId, address, false);
+}
+
+bool SimOS::WriteMemory( unsigned long long address ) {
+    return WriteMemory(0, address);
+}
+
+bool SimOS::WriteMemory( int coreId, unsigned long long address ) {
+    return touchMemory(coreId, address, true);
+}
+
+bool SimOS::touchMemory(int coreId, unsigned long long address, bool write) {
+    auto current = OSadded_ ? userProcessOn(coreId) : nullptr;
+    if (!current || address >= current->size_) {
+        return false;
     }
+    if (!paged_) {
+        return !write || !current->nextShare_ || copyRegion(current);
+    }
+    unsigned long long swapSlot = 0;
+    auto access = paged_->access(current, address, write, swapSlot);
+    if (access == PagedMemory::Access::SWAP_IN) {
+        //the frame is already reserved, the process waits for the page like for any read
+        readFor(coreId, paged_->settings().swapDisk, FileReadRequest{0, "swap", swapSlot, 1}, false);
+    }
+    return access != PagedMemory::Access::INVALID && access != PagedMemory::Access::NO_MEMORY;
+}
 
-    return RAM_;
+void SimOS::shareRegion(Process* parent, Process* child) {
+    if (!parent->nextShare_) {
+        parent->prevShare_ = parent->nextShare_ = parent;
+        memoryStats_.privateBytes -= parent->size_;
+        memoryStats_.sharedBytes += parent->size_;
+    }
+    child->prevShare_ = parent;
+    child->nextShare_ = parent->nextShare_;
+    parent->nextShare_->prevShare_ = child;
+    parent->nextShare_ = child;
 }
 
-void SimOS::DiskReadRequest( int diskNumber, std::string fileName ) {
-    if (!currentProcess || !OSadded_ || currentProcess->PID_ == 1 || currentProcess->PID_ == NO_PROCESS || diskNumber >= numberOfDisks_) {
+Process* SimOS::unshareRegion(Process* ptr) {
+    auto other = ptr->nextShare_;
+    other->prevShare_ = ptr->prevShare_;
+    ptr->prevShare_->nextShare_ = other;
+    ptr->prevShare_ = ptr->nextShare_ = nullptr;
+    if (other->nextShare_ == other) {
+        //last one left owns it alone
+        other->prevShare_ = other->nextShare_ = nullptr;
+        memoryStats_.sharedBytes -= other->size_;
+        memoryStats_.privateBytes += other->size_;
+    }
+    return other;
+}
+
+//write to a shared region: ptr moves to a copy of its own, placed like a new process
+bool SimOS::copyRegion(Process* ptr) {
+    unsigned long long address = 0;
+    if (!allocateRAM(ptr->size_, address)) {
+        placementFailed(ptr->size_);
+        return false;
+    }
+    auto memItem = findItem(RAM_, ptr);
+    auto other = unshareRegion(ptr);
+    if (memItem != RAM_.end() && memItem->second.PID == ptr->PID_) {
+        memItem->second.PID = other->PID_;
+    }
+    RAM_.emplace(address, MemoryItem{address, ptr->size_, ptr->PID_});
+    remainingRAM_ -= placement_->footprint(ptr->size_);
+    ptr->memoryAddress_ = address;
+    ++memoryStats_.cowCopies;
+    memoryStats_.privateBytes += ptr->size_;
+    return true;
+}
+
+MemoryStats SimOS::GetMemoryStats() const {
+    return paged_ ? paged_->stats() : memoryStats_;
+}
+
+CompactionStats SimOS::GetCompactionStats() const {
+    return compactionStats_;
+}
+
+FragmentationStats SimOS::GetFragmentationStats() const {
+    FragmentationStats stats;
+    stats.fragmentationFailures = fragmentationFailures_;
+    stats.capacityFailures = capacityFailures_;
+    if (paged_) {
+        auto pageSize = paged_->pageSize();
+        stats.freeBytes = paged_->freeBytes();
+        stats.holes = stats.freeBytes / pageSize;
+        stats.largestHole = stats.holes > 0 ? pageSize : 0;
+        if (stats.holes > 0) {
+            stats.holeSizes[HoleHistogram::bucketOf(pageSize)] = stats.holes;
+        }
+        return stats;
+    }
+    const auto& histogram = placement_->histogram();
+    stats.holes = histogram.holes;
+    stats.largestHole = placement_->largestHole();
+    stats.freeBytes = histogram.freeBytes;
+    stats.holeSizes = histogram.buckets;
+    if (stats.freeBytes > 0) {
+        stats.externalFragmentation = 1.0 - static_cast<double>(stats.largestHole) / static_cast<double>(stats.freeBytes);
+    }
+    return stats;
+}
+
+MemoryUsage SimOS::GetMemoryUsage( int PID ) const {
+    auto ptr = OSadded_ ? processTable_.find(PID) : nullptr;
+    if (!ptr) {
+        return MemoryUsage{};
+    }
+    if (paged_) {
+        return paged_->usage(ptr);
+    }
+    if (ptr->nextShare_) {
+        return MemoryUsage{ptr->size_, 0};
+    }
+    //zombies have no memory left
+    auto memItem = findItem(RAM_, ptr);
+    bool resident = memItem != RAM_.end() && memItem->second.PID == PID;
+    return MemoryUsage{0, resident ? ptr->size_ : 0};
+}
+
+void SimOS::DiskReadRequest( int diskNumber, std::string fileName, unsigned long long block, unsigned long long size ) {
+    DiskReadRequest(0, diskNumber, std::move(fileName), block, size);
+}
+
+void SimOS::DiskReadRequest( int coreId, int diskNumber, std::string fileName, unsigned long long block, unsigned long long size ) {
+    readFor(coreId, diskNumber, FileReadRequest{0, std::move(fileName), block, size}, true);
+}
+
+//the process running on coreId blocks on request (PID filled in here)
+void SimOS::readFor(int coreId, int diskNumber, const FileReadRequest& request, bool mergeable) {
+    auto current = OSadded_ ? userProcessOn(coreId) : nullptr;
+    if (!current || diskNumber >= numberOfDisks_) {
         return;
     } 
-    updateCurrProcess();
+    schedule(coreId);
+    current = cores_[coreId]->current;
     
+    auto read = request;
+    read.PID = current->PID_;
+    queueRequest(diskNumber, read, current, mergeable);
+    //start next process
+    cores_[coreId]->current = nullptr;
+    schedule(coreId);
+}
+
+void SimOS::queueRequest(int diskNumber, const FileReadRequest& request, Process* ptr, bool mergeable) {
     //first check if disk already being used
-    FileReadRequest requestMade {currentProcess->PID_, fileName};
     bool noCurrProcessInDisk = std::get<1>(currProcessInDisk[diskNumber]) == nullptr;
     if (noCurrProcessInDisk) {
-        //make current process run in disk
-        currProcessInDisk[diskNumber] = {requestMade, currentProcess};
+        //make process run in disk
+        waitingQueueInDisk[diskNumber].dispatch(request);
+        currProcessInDisk[diskNumber] = {request, ptr};
     } else {
-        waitingQueueInDisk[diskNumber].push({requestMade, currentProcess});
+        waitingQueueInDisk[diskNumber].push({request, ptr}, mergeable);
     }
+    ptr->currentDisk_ = diskNumber;
+}
 
-    currentProcess->currentDisk_ = diskNumber;
-    //start next process
-    currentProcess = nullptr;
-    updateCurrProcess();
+//a finished swap write leaves the process waiting for memory, anything else makes it ready
+void SimOS::finishRequest(Process* ptr) {
+    ptr->currentDisk_ = -1;
+    if (ptr->swap_ == SwapState::SWAPPING_OUT) {
+        swapper_.park(ptr);
+        return;
+    }
+    if (ptr->swap_ == SwapState::SWAPPING_IN) {
+        swapper_.resident(ptr);
+    }
+    scheduling_->wake(ptr);
+    makeReady(ptr, ptr->core_);
 }
 
 void SimOS::DiskJobCompleted( int diskNumber ) {
@@ -422,18 +1167,19 @@ void SimOS::DiskJobCompleted( int diskNumber ) {
     auto [finishedRequest, finishedProcessPtr] = currProcessInDisk[diskNumber];
     finishedProcessPtr->currentDisk_ = -1;
     currProcessInDisk[diskNumber] = {FileReadRequest{}, nullptr};
+    //requests merged into the job finish with it
+    waitingQueueInDisk[diskNumber].takeRiders(finishedRiders_);
     
     //load next process from queue if not empty queue
-    if (!waitingQueueInDisk[diskNumber].empty()) {
-        auto [nextRequest, nextProcessPtr] = waitingQueueInDisk[diskNumber].front();
-        waitingQueueInDisk[diskNumber].pop();
-        
-        currProcessInDisk[diskNumber] = {nextRequest, nextProcessPtr};
-    }
+    loadNextRequest(diskNumber);
 
-    //add finished process to sched and update current process
-    Scheduler.push({finishedProcessPtr->priority_, finishedProcessPtr});
-    updateCurrProcess();
+    //add finished processes to their core's queue and update that core
+    finishRequest(finishedProcessPtr);
+    for (auto& rider : finishedRiders_) {
+        finishRequest(std::get<1>(rider));
+    }
+    //parked processes may fit now
+    swapIn();
 }
 
 FileReadRequest SimOS::GetDisk(int diskNumber) {
@@ -451,22 +1197,88 @@ FileReadRequest SimOS::GetDisk(int diskNumber) {
 }
 
 std::queue<FileReadRequest> SimOS::GetDiskQueue( int diskNumber ) {
-    if (OSadded_ == false || diskNumber >= numberOfDisks_) {
-        return {};
+    std::queue<FileReadRequest> result;
+    for (auto& readRequest : ViewDiskQueue(diskNumber)) {
+        result.push(readRequest);
     }
-    //only send copy if queue is non-empty
-    bool noWaitingProcesses = waitingQueueInDisk[diskNumber].empty();
-    if (noWaitingProcesses) {
-        return {};
+    return result;
+}
+
+DiskQueueView SimOS::ViewDiskQueue( int diskNumber ) const {
+    if (OSadded_ == false || diskNumber < 0 || diskNumber >= numberOfDisks_) {
+        return DiskQueueView(noDiskQueue_.begin(), noDiskQueue_.end(), 0);
     }
+    auto& queue = waitingQueueInDisk[diskNumber];
+    return DiskQueueView(queue.begin(), queue.end(), queue.size());
+}
 
-    auto queueCopy = waitingQueueInDisk[diskNumber];
-    std::queue<FileReadRequest> result;
-    while (!queueCopy.empty()) {
-        auto [readRequest, ignore] = queueCopy.front();
-        queueCopy.pop();
-        result.push(readRequest);
+DiskQueueView SimOS::ViewDiskRiders( int diskNumber ) const {
+    if (OSadded_ == false || diskNumber < 0 || diskNumber >= numberOfDisks_) {
+        return DiskQueueView(noDiskQueue_.begin(), noDiskQueue_.end(), 0);
     }
+    auto& queue = waitingQueueInDisk[diskNumber];
+    return DiskQueueView(queue.ridersBegin(), queue.end(), queue.riderCount());
+}
 
-    return result;
+int SimOS::GetDiskCount() const {
+    return numberOfDisks_;
+}
+
+DiskStats SimOS::GetDiskStats( int diskNumber ) const {
+    if (diskNumber < 0 || diskNumber >= numberOfDisks_) {
+        return DiskStats{};
+    }
+    return waitingQueueInDisk[diskNumber].stats();
+}
+
+size_t SimOS::ApplyBatch( const SimCommand* commands, size_t count, SimResult* results, const std::vector<std::string>& fileNames ) {
+    bool deferrable = !swapper_.enabled();
+    for (size_t i = 0; i < count; ++i) {
+        const SimCommand& command = commands[i];
+        SimResult result = 0;
+        //only new process / disk complete just touch the ready queues, the rest depend on who holds a CPU
+        //-> flush first and schedule their own wakes (an exit waking its parent) at once
+        deferSchedule_ = deferrable && (command.type == CommandType::NEW_PROCESS || command.type == CommandType::DISK_COMPLETE);
+        if (!deferSchedule_) {
+            flushSchedule();
+        }
+        switch (command.type) {
+            case CommandType::NEW_PROCESS:
+                result = NewProcess(command.size, command.arg);
+                break;
+            case CommandType::FORK:
+                result = SimFork(command.core);
+                break;
+            case CommandType::EXIT:
+                SimExit(command.core);
+                break;
+            case CommandType::WAIT:
+                SimWait(command.core);
+                break;
+            case CommandType::DISK_READ:
+                if (command.fileId >= 0 && static_cast<size_t>(command.fileId) < fileNames.size()) {
+                    DiskReadRequest(command.core, command.arg, fileNames[command.fileId], command.block, command.size);
+                }
+                break;
+            case CommandType::DISK_COMPLETE:
+                DiskJobCompleted(command.arg);
+                break;
+            case CommandType::GET_CPU:
+                result = GetCPU(command.core);
+                break;
+            case CommandType::TIMER_TICK:
+                TimerTick();
+                break;
+            case CommandType::ACCESS_MEMORY:
+                result = AccessMemory(command.core, command.size);
+                break;
+            case CommandType::WRITE_MEMORY:
+                result = WriteMemory(command.core, command.size);
+                break;
+        }
+        results[i] = result;
+    }
+    flushSchedule();
+    deferSchedule_ = false;
+    return count;
 }
@@ -5,44 +5,116 @@
 #include <vector>
 #include <queue>
 #include <tuple>
-#include <list>
-#include <unordered_set>
+#include <map>
+#include <memory>
+#include <cstdint>
 #include "Process.h"
+#include "ReadyQueue.h"
+#include "ProcessTable.h"
+#include "NodePool.h"
+#include "DiskQueue.h"
+#include "View.h"
+#include "SimCommand.h"
+#include "PlacementPolicy.h"
+#include "SchedulingPolicy.h"
+#include "MemoryMap.h"
+#include "PagedMemory.h"
+#include "Swapper.h"
 
-//FOR DISK
-struct FileReadRequest {
-    int  PID{0};
-    std::string fileName{""};
+//Zero copy views over live state (see View.h)
+struct MemoryItemOf {
+    const MemoryItem& operator()(const std::pair<const unsigned long long, MemoryItem>& entry) const { return entry.second; }
 };
-
-//FOR RAM
-struct MemoryItem {
-    unsigned long long itemAddress;
-    unsigned long long itemSize;
-    int PID; 
+struct PIDOf {
+    int operator()(const Process* ptr) const { return ptr->PID_; }
+};
+struct RequestOf {
+    const FileReadRequest& operator()(const DiskQueue::Entry& entry) const { return std::get<0>(entry); }
 };
-using MemoryUse = std::vector<MemoryItem>;
+using MemoryView = View<RAMMap::const_iterator, MemoryItemOf>;               //address order
+using ReadyQueueView = View<ReadyQueue::const_iterator, PIDOf>;             //highest priority first
+using DiskQueueView = View<DiskQueue::const_iterator, RequestOf>;           //FIFO order
 
 //FOR CPU / PROCESS CLASS
 constexpr int NO_PROCESS{-1};
 
+//Optional behaviour picked at construction, defaults match the original simulator
+struct SimOSConfig {
+    PlacementType placement{PlacementType::WORST_FIT};
+    SchedulerSettings scheduler{};
+    int cores{1};               //simulated CPUs, 1 = the original single CPU simulator
+    DiskSettings disks{};       //per disk request scheduling, FIFO = the original queue
+    MemorySettings memory{};    //paged RAM instead of contiguous placement
+    CompactionSettings compaction{};    //contiguous RAM: slide items together when no hole fits
+    SwapSettings swap{};        //contiguous RAM: swap idle processes out to admit new ones
+};
+
 class SimOS {
     public: 
         //OS, RAM, CPU functions
-        SimOS( int numberOfDisks, unsigned long long amountOfRAM, unsigned long long sizeOfOS);
+        SimOS( int numberOfDisks, unsigned long long amountOfRAM, unsigned long long sizeOfOS, const SimOSConfig& config = SimOSConfig{});
         bool NewProcess( unsigned long long size, int priority );
         bool SimFork();
         void SimExit();
         void SimWait();
         int GetCPU();
+        //one tick of the scheduling clock on every core, only time-slicing policies (SimOSConfig::scheduler) use it
+        void TimerTick();
         std::vector<int> GetReadyQueue();
         MemoryUse GetMemory();
+        ReadyQueueView ViewReadyQueue() const;
+        MemoryView ViewMemory() const;
+
+        //SMP (SimOSConfig::cores), the calls without a core act on core 0
+        //the OS process lives on core 0, other cores show NO_PROCESS when idle
+        int GetCoreCount() const;
+        bool SimFork( int coreId );
+        void SimExit( int coreId );
+        void SimWait( int coreId );
+        int GetCPU( int coreId );
+        std::vector<int> GetReadyQueue( int coreId );
+        ReadyQueueView ViewReadyQueue( int coreId ) const;
+        void DiskReadRequest( int coreId, int diskNumber, std::string fileName, unsigned long long block = 0, unsigned long long size = 0 );
+        //pin a process to one core (coreId -1 lets it run anywhere), false for the OS / unknown PID / core
+        bool SetAffinity( int PID, int coreId );
+        
+        //Paged memory (SimOSConfig::memory): the running process touches one byte of its own memory
+        //a page that isn't resident faults in, one read back from swap blocks the process on the swap disk
+        //false if no user process runs on the core or the address is outside it
+        //contiguous memory only checks the address
+        bool AccessMemory( unsigned long long address );
+        bool AccessMemory( int coreId, unsigned long long address );
+        //same, but a write to memory shared by a copy on write fork (MemorySettings::copyOnWrite) makes
+        //a private copy first (the whole region when contiguous, one page when paged), false if it doesn't fit
+        bool WriteMemory( unsigned long long address );
+        bool WriteMemory( int coreId, unsigned long long address );
+        MemoryStats GetMemoryStats() const;
+        MemoryUsage GetMemoryUsage( int PID ) const;
+        CompactionStats GetCompactionStats() const;
+        //holes, free bytes and failed placements without a pass over RAM, cheap enough to sample every call
+        //paged: any free frame serves any page, so each one is a hole and there is no external fragmentation
+        FragmentationStats GetFragmentationStats() const;
+
+        //Swapping (SimOSConfig::swap): a NewProcess that doesn't fit swaps idle processes out until it does
+        //a swapped process leaves its ready queue and RAM, shows up on the swap disk while it is written
+        //and read back, and is read back (oldest first) once an exit or a finished disk job leaves room
+        SwapStats GetSwapStats() const;
         
         //Disk functions
-        void DiskReadRequest( int diskNumber, std::string fileName );
+        //block / size place the read on the disk for the seek-aware policies (SimOSConfig::disks)
+        void DiskReadRequest( int diskNumber, std::string fileName, unsigned long long block = 0, unsigned long long size = 0 );
         void DiskJobCompleted( int diskNumber );
         FileReadRequest GetDisk( int diskNumber );
         std::queue<FileReadRequest> GetDiskQueue( int diskNumber );
+        DiskQueueView ViewDiskQueue( int diskNumber ) const;
+        DiskQueueView ViewDiskRiders( int diskNumber ) const;     //merged into GetDisk's job, finish with it
+        int GetDiskCount() const;
+        DiskStats GetDiskStats( int diskNumber ) const;
+
+        //Apply count commands in one pass, results[i] gets the result of commands[i]
+        //Preemption checks are deferred until the CPU is observable (any command but new process / disk complete,
+        //or the end of the batch), not with swapping on since its victims come from the ready queues
+        size_t ApplyBatch( const SimCommand* commands, size_t count, SimResult* results, const std::vector<std::string>& fileNames );
 
     private:
         //OS data members
@@ -53,31 +125,106 @@ class SimOS {
         
         //Process management
         int trackPID_;
-        std::list<Process> processList;
-        std::unordered_set<Process*> waitingParents;
-        Process* currentProcess;
-        void updateCurrProcess();
-        bool parentFork();
+        ProcessTable processTable_;
+        bool parentFork(int coreId);
         void removeFromRAM(int PID);
-        void removeFromScheduler(Process* ptr);
         void removeFromProcessList(Process* ptr);
         void removeFromDisk(Process* ptr);
         void removeFromDiskQueue(Process* ptr);
         void removeFromAnyDisk(Process* ptr);
-        void killFamilyTree(Process* ptr);      //recursive family killer
+        void removeFromDisks(const std::vector<Process*>& victims);
+        void loadNextRequest(int diskNumber);
+        void killFamilyTree(Process* ptr);      //iterative family killer (ptr + every descendant)
+        void exitProcess(int coreId);
+        std::vector<Process*> victims_;         //reused buffer for killFamilyTree
+        std::vector<int> vacated_;              //cores killFamilyTree took a process off
 
         //RAM management
-        MemoryUse RAM_; 
+        //resident items ordered by address, holes owned by the placement policy
+        //map nodes come from memoryPool_ so admission/exit churn doesn't hit malloc
+        NodePool memoryPool_;
+        RAMMap RAM_ {RAMAllocator{&memoryPool_}}; 
+        std::unique_ptr<PlacementPolicy> placement_;
+        std::unique_ptr<PagedMemory> paged_;    //paged mode: owns the frames, keeps RAM_ as runs of frames
         unsigned long long remainingRAM_;
-        bool fitInRAM(unsigned long long size);
-        int findWorstFitIndex();
+        unsigned long long fragmentationFailures_;
+        unsigned long long capacityFailures_;
+        bool fitInRAM(unsigned long long size, unsigned long long& address);
+        bool allocateRAM(unsigned long long size, unsigned long long& address);
+        void placementFailed(unsigned long long size);
+        void addToRAM(unsigned long long address, unsigned long long size);
+
+        //Compaction (SimOSConfig::compaction): when no hole fits size but remainingRAM_ does, one pass over
+        //RAM_ records every item and the gap below it, the mode picks a run of items and slides it down
+        //Moved items keep their order -> each node is re-keyed in place, the processes follow
+        CompactionSettings compaction_;
+        CompactionStats compactionStats_;
+        std::vector<RAMMap::iterator> compactItems_;        //reused by compact
+        std::vector<unsigned long long> compactGaps_;       //gap below item i, the last one is the top of RAM
+        bool compact(unsigned long long size);
+        void moveItem(RAMMap::iterator item, unsigned long long address);
+
+        //Medium-term scheduling: candidates follow the ready queues (enqueue / dequeue)
+        Swapper swapper_;
+        using SwapRuns = std::map<unsigned long long, unsigned long long, std::less<unsigned long long>,
+                                  PoolAllocator<std::pair<const unsigned long long, unsigned long long>>>;
+        std::vector<Process*> swapPlan_;        //reused by swapOutFor
+        SwapRuns swapRuns_ {SwapRuns::allocator_type{&memoryPool_}};   //free runs the plan would open, start -> end
+        bool swapOutFor(unsigned long long size, int priority);
+        void swapOut(Process* ptr);
+        void swapIn();
+        bool touchMemory(int coreId, unsigned long long address, bool write);
+
+        //Copy on write (contiguous): forked processes share one RAM item through a ring of sharers,
+        //the item is listed under one of them and goes away with the last
+        bool copyOnWrite_;
+        MemoryStats memoryStats_;               //contiguous counters, paged_ keeps its own
+        void shareRegion(Process* parent, Process* child);
+        Process* unshareRegion(Process* ptr);   //returns a process still sharing
+        bool copyRegion(Process* ptr);
 
-        //CPU scheduling using maxHeap
-        //Tuple is (priority, PID) order
-        std::priority_queue<std::tuple<int, Process*>> Scheduler;  
+        //CPU scheduling, ranks set by the policy
+        //Per rank FIFO run queues + bitmap -> O(1) push/pop/removal of any process
+        //One run queue per core; new/woken processes prefer an idle core and a core that runs dry
+        //steals from one with queued work. Both are found through bitmaps -> no pass over cores or processes
+        struct Core {
+            Process* current {nullptr};
+            ReadyQueue ready;
+            int movable {0};                    //queued processes without affinity (can be stolen)
+            Process* pendingTop {nullptr};      //ApplyBatch: would be running, still queued
+            unsigned long long pendingSequence {0};     //reserved for current when pendingTop preempted it
+            Core(long long low, int levels) : ready{low, levels} {}
+        };
+        std::unique_ptr<SchedulingPolicy> scheduling_;
+        std::vector<std::unique_ptr<Core>> cores_;
+        std::vector<std::uint64_t> idleCores_;      //nothing but the OS running
+        std::vector<std::uint64_t> donorCores_;     //movable > 0
+        int nextCore_;                              //round robin home for new processes
+        unsigned long long ticks_;
+        unsigned long long dispatches_;             //stamps Process::lastRun_
+        bool validCore(int coreId) const;
+        Process* userProcessOn(int coreId) const;   //running process unless idle / OS
+        void schedule(int coreId);                  //preempt / dispatch on one core, steal if it ran dry
+        void makeReady(Process* ptr, int preferredCore);
+        bool deferWake(int coreId, Process* ptr);  //record a preemption inside ApplyBatch, false = schedule now
+        void flushSchedule();                       //apply the deferred preemptions
+        void flushCore(int coreId);                 //apply one core's, if any
+        bool deferSchedule_;                        //inside ApplyBatch
+        std::vector<int> pendingCores_;             //cores with a pendingTop
+        void enqueue(int coreId, Process* ptr, unsigned long long sequence = ReadyQueue::NEXT_SEQUENCE);
+        void dequeue(Process* ptr);
+        Process* steal(int thief);
+        void markCore(int coreId);
 
         //Disk management
-        std::vector<std::queue<std::tuple<FileReadRequest,Process*>>> waitingQueueInDisk;
+        //waiting requests per disk, O(1) removal of any process
+        std::vector<DiskQueue> waitingQueueInDisk;
+        DiskQueue noDiskQueue_;                 //empty queue behind views of invalid disks
+        std::vector<DiskQueue::Entry> finishedRiders_;     //reused by DiskJobCompleted
         std::vector<std::tuple<FileReadRequest,Process*>> currProcessInDisk;
+        //swapper and pager traffic is never merged with other reads (see DiskQueue.h)
+        void readFor(int coreId, int diskNumber, const FileReadRequest& request, bool mergeable);
+        void queueRequest(int diskNumber, const FileReadRequest& request, Process* ptr, bool mergeable = true);
+        void finishRequest(Process* ptr);
 };
 
@@ -0,0 +1,314 @@
+//Jacky Qiu
+//----------------------------------
+//Benchmarks for SimOS hot paths
+//
+//  SimOS_Bench [maxN] [--replay trace.bin]
+//
+//Every case runs for n = 10, 100, ... maxN (default 100000) in its own forked process
+//so peak RSS belongs to that case alone. Results are printed as one JSON object per line:
+//  {"bench":..., "n":..., "frag":..., "ns_per_op":..., "allocs_per_op":..., "peak_rss_kb":...}
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "SimOS.h"
+#include "TraceReplayer.h"
+
+//count every heap allocation made while a benchmark runs
+static unsigned long long allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+//accumulates time & allocations of the measured sections only (setup is excluded)
+class Timer {
+    public:
+        template <typename Body>
+        void time(long long ops, Body body) {
+            auto startAllocs = allocationCount;
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            ns_ += std::chrono::duration<double, std::nano>(end - start).count();
+            allocs_ += allocationCount - startAllocs;
+            ops_ += ops;
+        }
+        double nsPerOp() const { return ops_ ? ns_ / ops_ : 0; }
+        double allocsPerOp() const { return ops_ ? static_cast<double>(allocs_) / ops_ : 0; }
+    private:
+        double ns_ {0};
+        unsigned long long allocs_ {0};
+        long long ops_ {0};
+};
+
+void report(const char* name, long long n, const char* frag, const Timer& timer) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::printf("{\"bench\":\"%s\",\"n\":%lld,\"frag\":\"%s\",\"ns_per_op\":%.1f,\"allocs_per_op\":%.3f,\"peak_rss_kb\":%ld}\n",
+        name, n, frag, timer.nsPerOp(), timer.allocsPerOp(), usage.ru_maxrss);
+}
+
+//small n repeats the case so every row covers at least this many operations
+constexpr long long MIN_OPS {100'000};
+long long repsFor(long long n) {
+    return n >= MIN_OPS ? 1 : MIN_OPS / n;
+}
+
+constexpr unsigned long long BLOCK {1000};
+constexpr unsigned long long HUGE_RAM {1ULL << 60};
+
+enum class Frag { NONE, LIGHT, HEAVY };
+const char* fragName(Frag frag) {
+    switch (frag) {
+        case Frag::LIGHT: return "light";
+        case Frag::HEAVY: return "heavy";
+        default: return "none";
+    }
+}
+
+//n resident BLOCK sized processes, then every 10th (LIGHT) or every 2nd (HEAVY) exits
+//doomed processes get the higher priority so SimExit always hits one of them
+void fragment(SimOS& sim, long long n, Frag frag) {
+    long long every = frag == Frag::HEAVY ? 2 : frag == Frag::LIGHT ? 10 : 0;
+    long long doomed = 0;
+    for (long long i = 0; i < n; ++i) {
+        bool dies = every && i % every == 0;
+        sim.NewProcess(BLOCK, dies ? 1000 : 1);
+        doomed += dies;
+    }
+    for (long long i = 0; i < doomed; ++i) {
+        sim.SimExit();
+    }
+}
+
+//NEW PROCESS: n quarter-block admissions into fragmented RAM
+void newProcess(long long n, Frag frag, bool batched) {
+    Timer timer;
+    std::vector<SimCommand> commands (n, SimCommand{BLOCK / 4, 1, 0, CommandType::NEW_PROCESS});
+    std::vector<SimResult> results (n);
+    std::vector<std::string> noFiles;
+    for (long long rep = 0; rep < repsFor(n); ++rep) {
+        //tail leaves room for every admission even without holes
+        SimOS sim (1, 1 + n * BLOCK + n * BLOCK / 4, 1);
+        fragment(sim, n, frag);
+        if (batched) {
+            timer.time(n, [&]() { sim.ApplyBatch(commands.data(), n, results.data(), noFiles); });
+        } else {
+            timer.time(n, [&]() {
+                for (long long i = 0; i < n; ++i) {
+                    sim.NewProcess(BLOCK / 4, 1);
+                }
+            });
+        }
+    }
+    report(batched ? "new_process_batch" : "new_process", n, fragName(frag), timer);
+}
+
+//FORK: parent forks n children that stay alive
+void forkWide(long long n) {
+    Timer timer;
+    for (long long rep = 0; rep < repsFor(n); ++rep) {
+        SimOS sim (1, HUGE_RAM, 1);
+        sim.NewProcess(1, 10);
+        timer.time(n, [&]() {
+            for (long long i = 0; i < n; ++i) {
+                sim.SimFork();
+            }
+        });
+    }
+    report("fork_wide", n, "none", timer);
+}
+
+//FORK + WAIT + EXIT: n children born and reaped one after another
+void forkExitChurn(long long n) {
+    Timer timer;
+    for (long long rep = 0; rep < repsFor(n); ++rep) {
+        SimOS sim (1, HUGE_RAM, 1);
+        sim.NewProcess(1, 10);
+        timer.time(n, [&]() {
+            for (long long i = 0; i < n; ++i) {
+                sim.SimFork();
+                sim.SimWait();
+                sim.SimExit();
+            }
+        });
+    }
+    report("fork_exit_churn", n, "none", timer);
+}
+
+//EXIT: parent with n direct children exits, cost per killed process
+void exitWideTree(long long n) {
+    Timer timer;
+    for (long long rep = 0; rep < repsFor(n); ++rep) {
+        SimOS sim (1, HUGE_RAM, 1);
+        sim.NewProcess(1, 10);
+        for (long long i = 0; i < n; ++i) {
+            sim.SimFork();
+        }
+        timer.time(n, [&]() { sim.SimExit(); });
+    }
+    report("exit_wide_tree", n, "none", timer);
+}
+
+//EXIT: chain of n processes, each parent blocked on disk 0, then the root exits
+void exitDeepTree(long long n) {
+    Timer timer;
+    for (long long rep = 0; rep < repsFor(n); ++rep) {
+        SimOS sim (1, HUGE_RAM, 1);
+        sim.NewProcess(1, 10);
+        for (long long i = 0; i < n; ++i) {
+            sim.SimFork();
+            sim.DiskReadRequest(0, "abc");
+        }
+        sim.DiskReadRequest(0, "abc");
+        sim.DiskJobCompleted(0);
+        timer.time(n, [&]() { sim.SimExit(); });
+    }
+    report("exit_deep_tree", n, "none", timer);
+}
+
+//WAIT: parent reaps n zombies (one child stays alive on disk 1 so SimWait keeps working)
+void waitZombies(long long n) {
+    Timer timer;
+    for (long long rep = 0; rep < repsFor(n); ++rep) {
+        SimOS sim (2, HUGE_RAM, 1);
+        sim.NewProcess(1, 10);
+        for (long long i = 0; i <= n; ++i) {
+            sim.SimFork();
+        }
+        sim.DiskReadRequest(0, "abc");      //parent blocks, children run
+        sim.DiskReadRequest(1, "abc");      //first child stays alive
+        for (long long i = 0; i < n; ++i) {
+            sim.SimExit();                  //rest become zombies
+        }
+        sim.DiskJobCompleted(0);            //parent back
+        timer.time(n, [&]() {
+            for (long long i = 0; i < n; ++i) {
+                sim.SimWait();
+            }
+        });
+    }
+    report("wait_zombies", n, "none", timer);
+}
+
+//DISK: queue depth n on disk 0, each op completes one job and re-queues that process
+void diskChurn(long long n) {
+    Timer timer;
+    for (long long rep = 0; rep < repsFor(n); ++rep) {
+        SimOS sim (1, HUGE_RAM, 1);
+        for (long long i = 0; i < n; ++i) {
+            sim.NewProcess(1, 10);
+            sim.DiskReadRequest(0, "abc");
+        }
+        timer.time(n, [&]() {
+            for (long long i = 0; i < n; ++i) {
+                sim.DiskJobCompleted(0);
+                sim.DiskReadRequest(0, "abc");
+            }
+        });
+    }
+    report("disk_churn", n, "none", timer);
+}
+
+//GETTERS: n processes ready, resident and queued on disk 0, cost per call
+void getters(long long n) {
+    SimOS sim (1, HUGE_RAM, 1);
+    for (long long i = 0; i < n; ++i) {
+        sim.NewProcess(1, 10);
+        sim.DiskReadRequest(0, "abc");
+    }
+    for (long long i = 0; i < n; ++i) {
+        sim.NewProcess(1, 10);
+    }
+    long long calls = std::max(1LL, MIN_OPS / n);
+    long long sink = 0;
+    auto run = [&](const char* name, std::function<void()> call) {
+        Timer timer;
+        timer.time(calls, [&]() {
+            for (long long i = 0; i < calls; ++i) {
+                call();
+            }
+        });
+        report(name, n, "none", timer);
+    };
+    run("get_ready_queue", [&]() { sink += sim.GetReadyQueue().size(); });
+    run("get_memory", [&]() { sink += sim.GetMemory().size(); });
+    run("get_disk_queue", [&]() { sink += sim.GetDiskQueue(0).size(); });
+    run("view_ready_queue", [&]() { for (int PID : sim.ViewReadyQueue()) { sink += PID; } });
+    run("view_memory", [&]() { for (auto& memItem : sim.ViewMemory()) { sink += memItem.PID; } });
+    run("view_disk_queue", [&]() { for (auto& request : sim.ViewDiskQueue(0)) { sink += request.PID; } });
+    if (sink == 42) {
+        std::printf("\n");
+    }
+}
+
+//run one case in a child so its peak RSS is its own
+void isolated(std::function<void()> bench) {
+    std::fflush(stdout);
+    pid_t child = fork();
+    if (child == 0) {
+        bench();
+        std::fflush(stdout);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+}
+
+void replayTrace(const char* path) {
+    TraceReplayer replayer (path);
+    if (!replayer.valid()) {
+        std::fprintf(stderr, "cannot read trace %s\n", path);
+        return;
+    }
+    auto stats = replayer.replay();
+    std::printf("{\"bench\":\"replay\",\"calls\":%zu,\"bytes\":%zu,\"complete\":%s,\"mismatches\":%zu,\"calls_per_sec\":%.0f}\n",
+        stats.calls, replayer.bytes(), stats.complete ? "true" : "false", stats.mismatches, 
+        stats.seconds > 0 ? stats.calls / stats.seconds : 0);
+}
+
+int main(int argc, char* argv[]) {
+    long long maxN = 100'000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayTrace(argv[++i]);
+            return 0;
+        }
+        maxN = std::atoll(argv[i]);
+    }
+
+    for (long long n = 10; n <= maxN; n *= 10) {
+        for (Frag frag : {Frag::NONE, Frag::LIGHT, Frag::HEAVY}) {
+            isolated([=]() { newProcess(n, frag, false); });
+            isolated([=]() { newProcess(n, frag, true); });
+        }
+        isolated([=]() { forkWide(n); });
+        isolated([=]() { forkExitChurn(n); });
+        isolated([=]() { exitWideTree(n); });
+        isolated([=]() { exitDeepTree(n); });
+        isolated([=]() { waitZombies(n); });
+        isolated([=]() { diskChurn(n); });
+        isolated([=]() { getters(n); });
+    }
+}
@@ -1,6 +1,14 @@
 #include <cassert>
+#include <fstream>
 #include <iostream>
+#include <unordered_set>
 #include "SimOS.h"
+#include "TraceRecorder.h"
+#include "TraceReplayer.h"
+#include "WorkloadGenerator.h"
+#include "EventEngine.h"
+#include "ConcurrentSimOS.h"
+#include "SweepRunner.h"
 #define OS_SIZE 10'000'000'000
 #define OS_DISKS 3
 #define OS_RAM 64'000'000'000 //64GB RAM
@@ -394,6 +402,7 @@ void exitTests() {
     bool forkWaitExit = true;
     bool orphanExit = true;
     bool nestedOrphanExit = true;
+    bool deepTreeExit = true;
 
     if (simpleExit) {
         SimOS test (OS_DISKS, OS_RAM, OS_SIZE); //1
@@ -496,11 +505,42 @@ void exitTests() {
             std::cout << "EXIT TEST 4: FAIL" << std::endl;
         }
     }
+
+    if (deepTreeExit) {
+        const int depth = 100'000;
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE); //1
+        test.NewProcess(1, 10);                 //2 root of the chain
+        for (int i = 0; i < depth; ++i) {
+            test.SimFork();                     //child of whoever is running
+            test.DiskReadRequest(0, "abc");     //parent blocks -> child runs
+        }
+        test.DiskReadRequest(0, "abc");         //last child blocks too
+        assert(test.GetCPU() == 1);
+        test.DiskJobCompleted(0);               //2 comes back
+        assert(test.GetCPU() == 2);
+        test.SimExit();                         //kills 100k deep family without recursion
+
+        bool result = (
+            test.GetCPU() == 1 &&
+            test.GetReadyQueue().empty() &&
+            test.GetMemory().size() == 1 &&
+            test.GetDisk(0).PID == 0 &&
+            test.GetDiskQueue(0).empty()
+        );
+
+        if (result) {
+            assert(result);
+            std::cout << "EXIT TEST 5: PASS" << std::endl;
+        } else {
+            std::cout << "EXIT TEST 5: FAIL" << std::endl;
+        }
+    }
 }
 
 void diskTests() {
     bool ReadRequestWorks = true;
     bool ReadRequstJobComplete = true;
+    bool cancelQueuedRequest = true;
     if (ReadRequestWorks) {
         SimOS test (OS_DISKS, OS_RAM, OS_SIZE); //1
         test.NewProcess(1000,1000);             //2
@@ -550,6 +590,43 @@ void diskTests() {
             std::cout << "DISK TEST 2: FAIL" << std::endl;
         }
     }
+
+    if (cancelQueuedRequest) {
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE); //1
+        test.NewProcess(1000,10);               //2
+        test.DiskReadRequest(0, "a");           //2 using Disk 0
+        test.NewProcess(1000,9);                //3
+        test.DiskReadRequest(0, "b");           //Disk 0 queue : [ 3 ]
+        test.NewProcess(1000,8);                //4 parent
+        test.SimFork();                         //5 child of 4
+        test.DiskReadRequest(1, "x");           //4 using Disk 1 -> 5 runs
+        test.DiskReadRequest(0, "c");           //Disk 0 queue : [ 3 5 ]
+        test.NewProcess(1000,7);                //6
+        test.DiskReadRequest(0, "d");           //Disk 0 queue : [ 3 5 6 ]
+        assert(test.GetCPU() == 1);
+
+        test.DiskJobCompleted(1);               //4 comes back
+        assert(test.GetCPU() == 4);
+        test.SimExit();                         //4 exits -> 5 dropped from middle of queue
+
+        std::vector<int> orderedPID {3,6};
+        auto queue = test.GetDiskQueue(0);
+        bool result = processDNE(test, 5, 1) && test.GetDisk(0).PID == 2 && queue.size() == orderedPID.size();
+        for (int i = 0; !queue.empty(); ++i) {
+            result = result && queue.front().PID == orderedPID[i];
+            queue.pop();
+        }
+
+        test.DiskJobCompleted(0);               //2 done -> 3 uses Disk 0
+        result = result && test.GetDisk(0).PID == 3 && test.GetDisk(0).fileName == "b" && test.GetDiskQueue(0).size() == 1;
+
+        if (result) {
+            assert(result);
+            std::cout << "DISK TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "DISK TEST 3: FAIL" << std::endl;
+        }
+    }
 }
 
 void RAMTests() {
@@ -557,6 +634,8 @@ void RAMTests() {
     bool worstFitTest = true;
     bool forkRAM = true;
     bool OOMtest = true;
+    bool fragmentedTest = true;
+    bool zeroSizeTest = true;
     if (contiguousPID) {
         SimOS test (OS_DISKS, OS_RAM, OS_SIZE);
         //contiguous PID test
@@ -707,20 +786,2239 @@ void RAMTests() {
             std::cout << "RAM TEST 4: FAIL" << std::endl;
         }
     }
+    if (fragmentedTest) {
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE);     //1
+        test.NewProcess(20'000'000'000, 500);       //2
+        test.NewProcess(20'000'000'000, 100);       //3
+        test.NewProcess(14'000'000'000, 400);       //4 (MAX CAPACITY)
+
+        test.SimExit();                             //2 exits -> 20GB hole
+        assert(test.GetCPU() == 4);
+        test.SimExit();                             //4 exits -> 14GB hole at end
+        //PID order should be : [ 1 3 ]
+
+        bool result = true;
+        result = result && (test.NewProcess(25'000'000'000, 1) == false); //34GB free but largest hole is 20GB
+        assert(result);
+        result = result && test.NewProcess(20'000'000'000, 1);           //5 fills left hole exactly
+        //PID order should be : [ 1 5* 3 ]
+
+        std::vector<int> orderedPID {1,5,3};
+        std::vector<unsigned long long> orderedAddress {0, 10'000'000'000, 30'000'000'000};
+        auto RAM = test.GetMemory();
+        assert(RAM.size() == orderedPID.size());
+        int i = 0;
+        for (auto memItem : RAM) {
+            result = result && (memItem.PID == orderedPID[i]) && (memItem.itemAddress == orderedAddress[i]);
+            assert(memItem.PID == orderedPID[i] && memItem.itemAddress == orderedAddress[i]);
+            ++i;
+        }
+
+        if (result) {
+            assert(result);
+            std::cout << "RAM TEST 5: PASS" << std::endl;
+        } else {
+            std::cout << "RAM TEST 5: FAIL" << std::endl;
+        }
+    }
+    if (zeroSizeTest) {
+        SimOS test (1, 100, 10);                    //1 @0
+        test.NewProcess(0, 5);                      //2 @10, takes no room
+        test.NewProcess(10, 5);                     //3 @10 too, right after 2
+        test.NewProcess(10, 6);                     //4 @20
+        //PID order should be : [ 1 2 3 4 ]
+
+        std::vector<int> orderedPID {1,2,3,4};
+        std::vector<unsigned long long> orderedAddress {0, 10, 10, 20};
+        auto RAM = test.GetMemory();
+        bool result = RAM.size() == orderedPID.size();
+        assert(result);
+        for (size_t i = 0; result && i < RAM.size(); ++i) {
+            result = RAM[i].PID == orderedPID[i] && RAM[i].itemAddress == orderedAddress[i];
+            assert(result);
+        }
+        result = result && test.GetMemoryUsage(2).privateBytes == 0 && test.GetMemoryUsage(3).privateBytes == 10;
+        assert(result);
+
+        //every byte comes back once they're gone
+        while (test.GetCPU() != 1) {
+            test.SimExit();
+        }
+        result = result && test.GetMemory().size() == 1 && test.NewProcess(90, 1);
+        assert(result);
+        if (result) {
+            std::cout << "RAM TEST 6: PASS" << std::endl;
+        } else {
+            std::cout << "RAM TEST 6: FAIL" << std::endl;
+        }
+    }
 }
 
-int main() {
-    //same priority process does NOT kick out current process in CPU
-    OStests();      //1 test
-    std::cout << "-----------------------" << std::endl;
-    emptyTests();   //3 test
-    std::cout << "-----------------------" << std::endl;    
-    RAMTests();     //4 tests
-    std::cout << "-----------------------" << std::endl;
-    diskTests();    //2 tests
-    std::cout << "-----------------------" << std::endl;
-    exitTests();    //4 tests
-    std::cout << "-----------------------" << std::endl;
-    waitTests();    //5 tests 
+//builds holes: 10GB @10GB, 20GB @25GB, 14GB @50GB (last allocation ended @50GB)
+void makeHoles(SimOS& test) {
+    test.NewProcess(10'000'000'000, 500);       //2 @10GB
+    test.NewProcess(5'000'000'000, 100);        //3 @20GB
+    test.NewProcess(20'000'000'000, 400);       //4 @25GB
+    test.NewProcess(5'000'000'000, 50);         //5 @45GB
+    test.SimExit();                             //2 exits
+    test.SimExit();                             //4 exits
+}
+
+unsigned long long addressOfPID(SimOS& test, int PID) {
+    for (auto memItem : test.GetMemory()) {
+        if (memItem.PID == PID) {
+            return memItem.itemAddress;
+        }
+    }
+    return -1;
+}
+
+void placementTests() {
+    bool fitPolicies = true;
+    bool buddyPolicy = true;
+    if (fitPolicies) {
+        SimOS worst (OS_DISKS, OS_RAM, OS_SIZE, {PlacementType::WORST_FIT});
+        SimOS first (OS_DISKS, OS_RAM, OS_SIZE, {PlacementType::FIRST_FIT});
+        SimOS best (OS_DISKS, OS_RAM, OS_SIZE, {PlacementType::BEST_FIT});
+        SimOS next (OS_DISKS, OS_RAM, OS_SIZE, {PlacementType::NEXT_FIT});
+        makeHoles(worst);
+        makeHoles(first);
+        makeHoles(best);
+        makeHoles(next);
+
+        worst.NewProcess(8'000'000'000, 1);     //6 -> 20GB hole
+        first.NewProcess(8'000'000'000, 1);     //6 -> lowest hole
+        best.NewProcess(12'000'000'000, 1);     //6 -> 14GB hole
+        next.NewProcess(8'000'000'000, 1);      //6 -> first hole after 5
+
+        bool result = (
+            addressOfPID(worst, 6) == 25'000'000'000 &&
+            addressOfPID(first, 6) == 10'000'000'000 &&
+            addressOfPID(best, 6) == 50'000'000'000 &&
+            addressOfPID(next, 6) == 50'000'000'000
+        );
+
+        next.NewProcess(13'000'000'000, 1);     //7 -> nothing fits after 6, wraps to 20GB hole
+        result = result && addressOfPID(next, 7) == 25'000'000'000;
+
+        if (result) {
+            assert(result);
+            std::cout << "PLACEMENT TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "PLACEMENT TEST 1: FAIL" << std::endl;
+        }
+    }
+    if (buddyPolicy) {
+        SimOS test (OS_DISKS, 1024, 100, {PlacementType::BUDDY});   //1 -> 128 block @0
+        test.NewProcess(200, 10);               //2 -> 256 block @256
+        test.NewProcess(60, 5);                 //3 -> 64 block @128 (splits 128 @128)
+        bool result = (
+            addressOfPID(test, 1) == 0 &&
+            addressOfPID(test, 2) == 256 &&
+            addressOfPID(test, 3) == 128
+        );
+        assert(test.GetCPU() == 2);
+        test.SimExit();                         //2 exits, buddy @0 in use -> no merge
+        test.SimExit();                         //3 exits, merges back into 128 @128
+        result = result && test.NewProcess(120, 1);                 //4 -> 128 @128
+        result = result && test.NewProcess(250, 1);                 //5 -> 256 @256
+        result = result && test.NewProcess(600, 1) == false;        //no 1024 block
+        result = result && addressOfPID(test, 4) == 128 && addressOfPID(test, 5) == 256;
+
+        if (result) {
+            assert(result);
+            std::cout << "PLACEMENT TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "PLACEMENT TEST 2: FAIL" << std::endl;
+        }
+    }
+}
+
+void viewTests() {
+    SimOS test (OS_DISKS, OS_RAM, OS_SIZE);     //1
+    test.NewProcess(1000, 5);                   //2
+    test.NewProcess(1000, 7);                   //3
+    test.NewProcess(1000, 6);                   //4
+    test.DiskReadRequest(0, "abc");             //3 using Disk 0
+    test.DiskReadRequest(0, "def");             //4 waits on Disk 0
+    test.DiskReadRequest(0, "ghi");             //2 waits on Disk 0
+    test.NewProcess(1000, 3);                   //5
+    test.NewProcess(1000, 4);                   //6
+
+    //views walk live state in the same order the copies come back in
+    std::vector<int> readyQ;
+    for (int PID : test.ViewReadyQueue()) {
+        readyQ.push_back(PID);
+    }
+    std::vector<int> expectedReadyQ {5,1};
+    bool result = (readyQ == test.GetReadyQueue()) && (readyQ == expectedReadyQ) && test.GetCPU() == 6;
+
+    auto memory = test.GetMemory();
+    auto memoryView = test.ViewMemory();
+    result = result && memoryView.size() == memory.size();
+    int i = 0;
+    for (auto& memItem : memoryView) {
+        result = result && memItem.PID == memory[i].PID && memItem.itemAddress == memory[i].itemAddress;
+        ++i;
+    }
+
+    std::vector<int> diskQ;
+    for (auto& request : test.ViewDiskQueue(0)) {
+        diskQ.push_back(request.PID);
+    }
+    std::vector<int> expectedDiskQ {4,2};
+    result = result && diskQ == expectedDiskQ && test.GetDiskQueue(0).size() == 2;
+    result = result && test.ViewDiskQueue(1).empty() && test.ViewDiskQueue(OS_DISKS).empty();
+
+    if (result) {
+        assert(result);
+        std::cout << "VIEW TEST 1: PASS" << std::endl;
+    } else {
+        std::cout << "VIEW TEST 1: FAIL" << std::endl;
+    }
+}
+
+//same command through the normal one-call-at-a-time API
+SimResult applyDirect(SimOS& test, const SimCommand& command, const std::vector<std::string>& fileNames) {
+    switch (command.type) {
+        case CommandType::NEW_PROCESS: return test.NewProcess(command.size, command.arg);
+        case CommandType::FORK: return test.SimFork();
+        case CommandType::EXIT: test.SimExit(); return 0;
+        case CommandType::WAIT: test.SimWait(); return 0;
+        case CommandType::DISK_READ: test.DiskReadRequest(command.arg, fileNames[command.fileId], command.block, command.size); return 0;
+        case CommandType::DISK_COMPLETE: test.DiskJobCompleted(command.arg); return 0;
+        case CommandType::GET_CPU: return test.GetCPU();
+        case CommandType::TIMER_TICK: test.TimerTick(); return 0;
+        case CommandType::ACCESS_MEMORY: return test.AccessMemory(command.size);
+        case CommandType::WRITE_MEMORY: return test.WriteMemory(command.size);
+    }
+    return 0;
+}
+
+//same, through the per core calls
+SimResult applyOnCore(SimOS& test, const SimCommand& command, const std::vector<std::string>& fileNames) {
+    switch (command.type) {
+        case CommandType::FORK: return test.SimFork(command.core);
+        case CommandType::EXIT: test.SimExit(command.core); return 0;
+        case CommandType::WAIT: test.SimWait(command.core); return 0;
+        case CommandType::DISK_READ: test.DiskReadRequest(command.core, command.arg, fileNames[command.fileId]); return 0;
+        case CommandType::GET_CPU: return test.GetCPU(command.core);
+        default: return applyDirect(test, command, fileNames);
+    }
+}
+
+bool sameCores(SimOS& a, SimOS& b) {
+    bool result = a.GetCoreCount() == b.GetCoreCount();
+    for (int core = 0; result && core < a.GetCoreCount(); ++core) {
+        result = a.GetCPU(core) == b.GetCPU(core) && a.GetReadyQueue(core) == b.GetReadyQueue(core);
+    }
+    return result;
+}
+
+bool sameState(SimOS& a, SimOS& b) {
+    bool result = a.GetCPU() == b.GetCPU() && a.GetReadyQueue() == b.GetReadyQueue();
+    auto memoryA = a.GetMemory();
+    auto memoryB = b.GetMemory();
+    result = result && memoryA.size() == memoryB.size();
+    for (size_t i = 0; result && i < memoryA.size(); ++i) {
+        result = memoryA[i].PID == memoryB[i].PID && memoryA[i].itemAddress == memoryB[i].itemAddress;
+    }
+    for (int disk = 0; disk < OS_DISKS; ++disk) {
+        result = result && a.GetDisk(disk).PID == b.GetDisk(disk).PID;
+        auto queueA = a.GetDiskQueue(disk);
+        auto queueB = b.GetDiskQueue(disk);
+        result = result && queueA.size() == queueB.size();
+        while (result && !queueA.empty()) {
+            result = queueA.front().PID == queueB.front().PID && queueA.front().fileName == queueB.front().fileName;
+            queueA.pop();
+            queueB.pop();
+        }
+    }
+    return result;
+}
+
+void batchTests() {
+    bool mixedTrace = true;
+    bool deferredPlaces = true;
+
+    if (mixedTrace) {
+        std::vector<std::string> fileNames {"a", "b"};
+        std::vector<SimCommand> commands {
+            {1000, 5, 0, CommandType::NEW_PROCESS},     //2
+            {1000, 7, 0, CommandType::NEW_PROCESS},     //3 preempts 2
+            {1000, 7, 0, CommandType::NEW_PROCESS},     //4 ties with 3 -> no preempt
+            {1000, 6, 0, CommandType::NEW_PROCESS},     //5
+            {0, 0, 0, CommandType::GET_CPU},
+            {0, 0, 0, CommandType::DISK_READ},          //3 reads "a" on Disk 0
+            {0, 0, 0, CommandType::GET_CPU},
+            {0, 0, 0, CommandType::FORK},               //6 child of 4
+            {0, 1, 1, CommandType::DISK_READ},          //4 reads "b" on Disk 1
+            {2000, 9, 0, CommandType::NEW_PROCESS},     //7
+            {2000, 9, 0, CommandType::NEW_PROCESS},     //8 ties with 7
+            {0, 0, 0, CommandType::DISK_COMPLETE},      //3 back
+            {0, 0, 0, CommandType::GET_CPU},
+            {0, 0, 0, CommandType::EXIT},
+            {0, 0, 0, CommandType::WAIT},
+            {0, 0, 0, CommandType::GET_CPU},
+            {0, 1, 0, CommandType::DISK_COMPLETE},      //4 back
+            {0, 0, 0, CommandType::EXIT},
+            {0, 0, 0, CommandType::GET_CPU},
+            {1, 1, 0, CommandType::NEW_PROCESS},        //left pending at end of batch
+        };
+
+        SimOS batched (OS_DISKS, OS_RAM, OS_SIZE);
+        SimOS direct (OS_DISKS, OS_RAM, OS_SIZE);
+        std::vector<SimResult> batchResults (commands.size());
+        std::vector<SimResult> directResults;
+        batched.ApplyBatch(commands.data(), commands.size(), batchResults.data(), fileNames);
+        for (auto& command : commands) {
+            directResults.push_back(applyDirect(direct, command, fileNames));
+        }
+
+        bool result = (batchResults == directResults) && sameState(batched, direct);
+        if (result) {
+            assert(result);
+            std::cout << "BATCH TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "BATCH TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (deferredPlaces) {
+        //deferred preemptions leave the preempted processes where per-call scheduling put them
+        std::vector<std::string> fileNames {"a"};
+        std::vector<SimCommand> commands {
+            {1000, 5, 0, CommandType::NEW_PROCESS},     //2
+            {1000, 7, 0, CommandType::NEW_PROCESS},     //3 preempts 2 -> 2 queued now
+            {1000, 5, 0, CommandType::NEW_PROCESS},     //4 behind 2
+            {1000, 9, 0, CommandType::NEW_PROCESS},     //5 preempts 3 -> 3 queued now
+            {1000, 7, 0, CommandType::NEW_PROCESS},     //6 behind 3
+            {0, 0, 0, CommandType::GET_CPU},
+            {0, 0, 0, CommandType::DISK_READ},          //5 reads "a"
+            {1000, 9, 0, CommandType::NEW_PROCESS},     //7 preempts 3 -> behind 6
+            {1000, 7, 0, CommandType::NEW_PROCESS},     //8 behind 3
+            {0, 0, 0, CommandType::DISK_COMPLETE},      //5 back, ties with 7
+            {1000, 5, 0, CommandType::NEW_PROCESS},     //9 left pending behind 4
+        };
+        SimOS batched (OS_DISKS, OS_RAM, OS_SIZE);
+        SimOS direct (OS_DISKS, OS_RAM, OS_SIZE);
+        std::vector<SimResult> batchResults (commands.size());
+        std::vector<SimResult> directResults;
+        batched.ApplyBatch(commands.data(), commands.size(), batchResults.data(), fileNames);
+        for (auto& command : commands) {
+            directResults.push_back(applyDirect(direct, command, fileNames));
+        }
+        bool result = (batchResults == directResults) && sameState(batched, direct) &&
+                      direct.GetReadyQueue() == std::vector<int>{5, 6, 3, 8, 2, 4, 9, 1};
+
+        //every core defers its own preemption, idle cores still take new work at once
+        SimOSConfig config;
+        config.cores = 2;
+        SimOS batchedCores (OS_DISKS, OS_RAM, OS_SIZE, config);
+        SimOS directCores (OS_DISKS, OS_RAM, OS_SIZE, config);
+        std::vector<SimCommand> wakes {
+            {1000, 5, 0, CommandType::NEW_PROCESS},     //2 core 0
+            {1000, 5, 0, CommandType::NEW_PROCESS},     //3 core 1
+            {1000, 7, 0, CommandType::NEW_PROCESS},     //4 preempts 2
+            {1000, 8, 0, CommandType::NEW_PROCESS},     //5 preempts 3
+            {1000, 5, 0, CommandType::NEW_PROCESS},     //6 behind 2
+            {1000, 5, 0, CommandType::NEW_PROCESS},     //7 behind 3
+        };
+        batchResults.assign(wakes.size(), 0);
+        batchedCores.ApplyBatch(wakes.data(), wakes.size(), batchResults.data(), fileNames);
+        for (auto& command : wakes) {
+            applyDirect(directCores, command, fileNames);
+        }
+        result = result && directCores.GetCPU(0) == 4 && directCores.GetCPU(1) == 5 && sameCores(batchedCores, directCores);
+
+        //a core running dry mid batch must not steal a process another core is about to run
+        std::vector<SimCommand> steals {
+            {10, 2, 0, CommandType::NEW_PROCESS},       //2 core 0
+            {0, 0, 0, CommandType::FORK, 0},            //3 -> idle core 1
+            {0, 0, 0, CommandType::WAIT, 0},            //2 waits
+            {10, 1, 0, CommandType::NEW_PROCESS},       //4 core 0
+            {0, 0, 0, CommandType::EXIT, 1},            //3 exits, 2 back on core 0, core 1 steals 4
+        };
+        SimOS batchedSteal (OS_DISKS, OS_RAM, OS_SIZE, config);
+        SimOS directSteal (OS_DISKS, OS_RAM, OS_SIZE, config);
+        batchResults.assign(steals.size(), 0);
+        batchedSteal.ApplyBatch(steals.data(), steals.size(), batchResults.data(), fileNames);
+        for (auto& command : steals) {
+            applyOnCore(directSteal, command, fileNames);
+        }
+        result = result && directSteal.GetCPU(0) == 2 && directSteal.GetCPU(1) == 4 && sameCores(batchedSteal, directSteal);
+
+        //random streams on 1 to 4 cores end where per-call scheduling ends
+        std::vector<std::string> files {"a", "b"};
+        for (std::uint64_t seed = 1; seed <= 200; ++seed) {
+            Random random (seed);
+            SimOSConfig cores;
+            cores.cores = 1 + static_cast<int>(seed % 4);
+            std::vector<SimCommand> stream (300);
+            for (auto& command : stream) {
+                command.type = static_cast<CommandType>(random.uniform(0, 6));     //NEW_PROCESS .. GET_CPU
+                command.core = static_cast<std::uint16_t>(random.uniform(0, cores.cores - 1));
+                command.size = random.uniform(1, 100);
+                command.arg = static_cast<int>(random.uniform(0, 5));
+                if (command.type == CommandType::DISK_READ || command.type == CommandType::DISK_COMPLETE) {
+                    command.arg = static_cast<int>(random.uniform(0, 1));
+                    command.fileId = static_cast<int>(random.uniform(0, 1));
+                }
+            }
+            SimOS batchedStream (2, 100000, 10, cores);
+            SimOS directStream (2, 100000, 10, cores);
+            std::vector<SimResult> streamResults (stream.size());
+            std::vector<SimResult> directStreamResults;
+            batchedStream.ApplyBatch(stream.data(), stream.size(), streamResults.data(), files);
+            for (auto& command : stream) {
+                directStreamResults.push_back(applyOnCore(directStream, command, files));
+            }
+            result = result && streamResults == directStreamResults && sameCores(batchedStream, directStream);
+        }
+
+        if (result) {
+            assert(result);
+            std::cout << "BATCH TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "BATCH TEST 2: FAIL" << std::endl;
+        }
+    }
+}
+
+void traceTests() {
+    const char* path = "simos_trace_test.bin";
+    {
+        TraceRecorder test (path, OS_DISKS, OS_RAM, OS_SIZE);  //1
+        test.NewProcess(10'000'000'000, 500);                   //2
+        test.NewProcess(5'000'000'000, 100);                    //3
+        test.SimFork();                                         //4 child of 2
+        test.NewProcess(20'000'000'000, 400);                   //5
+        test.DiskReadRequest(0, "abc");                         //2 using Disk 0
+        test.DiskReadRequest(0, "def");                         //5 waits on Disk 0
+        test.GetDisk(0);
+        test.GetDiskQueue(0);
+        test.SimExit();                                         //4 exits -> zombie of 2
+        test.GetMemory();
+        test.DiskJobCompleted(0);                               //2 back
+        test.SimWait();
+        test.GetReadyQueue();
+        test.GetCPU();
+        test.NewProcess(100'000'000'000, 1);                    //fails
+    }
+
+    TraceReplayer replayer (path);
+    auto stats = replayer.replay();
+    bool result = replayer.valid() && stats.complete && stats.mismatches == 0 && stats.calls == 15;
+
+    //same calls under another placement policy -> GetMemory no longer matches
+    SimOS buddy (OS_DISKS, OS_RAM, OS_SIZE, {PlacementType::BUDDY});
+    auto other = replayer.replay(buddy, true);
+    result = result && other.complete && other.mismatches > 0;
+    std::remove(path);
+
+    if (result) {
+        assert(result);
+        std::cout << "TRACE TEST 1: PASS" << std::endl;
+    } else {
+        std::cout << "TRACE TEST 1: FAIL" << std::endl;
+    }
+}
+
+void workloadTests() {
+    const char* path = "simos_workload_test.bin";
+    bool determinismCheck = true;
+    bool forkBombCheck = true;
+
+    if (determinismCheck) {
+        //same seed -> same stream, live or through a trace
+        WorkloadConfig config = fragmentationWorkload(42, 20000);
+        SimOS first (config.numberOfDisks, config.amountOfRAM, config.sizeOfOS, config.sim);
+        SimOS second (config.numberOfDisks, config.amountOfRAM, config.sizeOfOS, config.sim);
+        WorkloadGenerator firstRun (config);
+        WorkloadGenerator secondRun (config);
+        auto firstStats = firstRun.run(first);
+        auto secondStats = secondRun.run(second);
+        {
+            TraceRecorder recorder (path, config.numberOfDisks, config.amountOfRAM, config.sizeOfOS, config.sim);
+            WorkloadGenerator recorded (config);
+            recorded.run(recorder);
+        }
+        TraceReplayer replayer (path);
+        SimOS replayed (config.numberOfDisks, config.amountOfRAM, config.sizeOfOS, config.sim);
+        auto replay = replayer.replay(replayed, true);
+        std::remove(path);
+
+        //another seed -> another stream
+        config.seed = 43;
+        SimOS third (config.numberOfDisks, config.amountOfRAM, config.sizeOfOS, config.sim);
+        WorkloadGenerator thirdRun (config);
+        thirdRun.run(third);
+
+        //one priority for everyone -> every scheduling decision is a tie, still the same stream
+        WorkloadConfig ties = forkBombWorkload(42, 20000);
+        ties.minPriority = 5;
+        ties.maxPriority = 5;
+        SimOS firstTies (ties.numberOfDisks, ties.amountOfRAM, ties.sizeOfOS, ties.sim);
+        SimOS secondTies (ties.numberOfDisks, ties.amountOfRAM, ties.sizeOfOS, ties.sim);
+        WorkloadGenerator firstTiesRun (ties);
+        WorkloadGenerator secondTiesRun (ties);
+        auto firstTiesStats = firstTiesRun.run(firstTies);
+        auto secondTiesStats = secondTiesRun.run(secondTies);
+
+        bool result = (
+            (firstStats.calls == 20000) &&
+            (firstStats.admitted == secondStats.admitted) && (firstStats.rejected == secondStats.rejected) &&
+            (firstStats.rejected > 0) &&                            //tight RAM actually rejects
+            sameState(first, second) &&
+            replay.complete && replay.mismatches == 0 && replay.calls == 20000 &&
+            sameState(first, replayed) &&
+            !sameState(first, third) &&
+            (firstTiesStats.forks == secondTiesStats.forks) && (firstTiesStats.exits == secondTiesStats.exits) &&
+            sameState(firstTies, secondTies)
+        );
+        if (result) {
+            assert(result);
+            std::cout << "WORKLOAD TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "WORKLOAD TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (forkBombCheck) {
+        //fork heavy stream keeps forking inside its limits, every live process is in RAM once
+        //equal priorities run in enqueue order -> the stream and its fork count are the same on every build
+        WorkloadConfig config = forkBombWorkload(7, 50000);
+        config.maxDepth = 5;
+        SimOS test (config.numberOfDisks, config.amountOfRAM, config.sizeOfOS, config.sim);
+        WorkloadGenerator generator (config);
+        auto stats = generator.run(test);
+
+        std::unordered_set<int> resident;
+        for (auto& memItem : test.GetMemory()) {
+            resident.insert(memItem.PID);
+        }
+        bool result = (
+            (stats.forks > stats.admitted * 4) &&
+            (stats.failedForks == 0) &&
+            (resident.size() == test.GetMemory().size())
+        );
+        if (result) {
+            assert(result);
+            std::cout << "WORKLOAD TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "WORKLOAD TEST 2: FAIL" << std::endl;
+        }
+    }
+}
+
+void schedulerTests() {
+    bool roundRobinCheck = true;
+    bool feedbackCheck = true;
+    bool strideCheck = true;
+
+    if (roundRobinCheck) {
+        SimOSConfig roundRobin;
+        roundRobin.scheduler = {SchedulerType::ROUND_ROBIN, 2};
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE, roundRobin);     //1
+        SimOS strict (OS_DISKS, OS_RAM, OS_SIZE);               //1
+        for (SimOS* sim : {&test, &strict}) {
+            sim->NewProcess(1000, 5);                           //2
+            sim->NewProcess(1000, 5);                           //3
+            sim->NewProcess(1000, 5);                           //4
+            sim->NewProcess(1000, 1);                           //5 never gets a turn
+        }
+        test.TimerTick();
+        bool firstSlice = test.GetCPU() == 2;
+        test.TimerTick();                                       //2 goes to the back
+        bool secondSlice = test.GetCPU() == 3 && test.GetReadyQueue() == std::vector<int>{4, 2, 5, 1};
+        for (int i = 0; i < 4; ++i) {
+            test.TimerTick();
+            strict.TimerTick();
+        }
+        bool result = (
+            firstSlice && secondSlice &&
+            (test.GetCPU() == 2) && (test.GetReadyQueue() == std::vector<int>{3, 4, 5, 1}) &&
+            (strict.GetCPU() == 2)                              //default never time-slices
+        );
+
+        //scheduler settings travel in the trace header
+        const char* path = "simos_scheduler_test.bin";
+        {
+            TraceRecorder recorder (path, OS_DISKS, OS_RAM, OS_SIZE, roundRobin);
+            recorder.NewProcess(1000, 5);
+            recorder.NewProcess(1000, 5);
+            for (int i = 0; i < 5; ++i) {
+                recorder.TimerTick();
+                recorder.GetCPU();
+            }
+            recorder.GetReadyQueue();
+        }
+        TraceReplayer replayer (path);
+        auto stats = replayer.replay();
+        std::remove(path);
+        result = result && stats.complete && stats.mismatches == 0 && stats.calls == 13;
+
+        if (result) {
+            assert(result);
+            std::cout << "SCHEDULER TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "SCHEDULER TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (feedbackCheck) {
+        //A & B burn their allotments down the levels, D arrives at tick 5
+        //with aging every 5 ticks B is back on top and keeps the CPU, without it D preempts
+        auto runTo5 = [](int boostInterval) {
+            SimOSConfig feedback;
+            feedback.scheduler = {SchedulerType::MLFQ, 1, 3, boostInterval};
+            SimOS test (OS_DISKS, OS_RAM, OS_SIZE, feedback);  //1
+            test.NewProcess(1000, 1);                           //2 A
+            test.NewProcess(1000, 9);                           //3 B, priority ignored
+            std::vector<int> holders;
+            for (int i = 0; i < 5; ++i) {
+                test.TimerTick();
+                holders.push_back(test.GetCPU());
+            }
+            test.NewProcess(1000, 1);                           //4 D
+            holders.push_back(test.GetCPU());
+            return holders;
+        };
+        bool result = (
+            (runTo5(5) == std::vector<int>{3, 2, 2, 3, 3, 3}) &&
+            (runTo5(0) == std::vector<int>{3, 2, 2, 3, 3, 4})
+        );
+        if (result) {
+            assert(result);
+            std::cout << "SCHEDULER TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "SCHEDULER TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (strideCheck) {
+        //3 tickets vs 1 ticket -> 3:1 share of the ticks
+        SimOSConfig stride;
+        stride.scheduler = {SchedulerType::STRIDE, 1};
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE, stride);        //1
+        test.NewProcess(1000, 3);                               //2
+        test.NewProcess(1000, 1);                               //3
+        int heavyTicks = 0;
+        for (int i = 0; i < 400; ++i) {
+            heavyTicks += test.GetCPU() == 2;
+            test.TimerTick();
+        }
+        bool result = heavyTicks >= 295 && heavyTicks <= 305;
+        if (result) {
+            assert(result);
+            std::cout << "SCHEDULER TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "SCHEDULER TEST 3: FAIL" << std::endl;
+        }
+    }
+}
+
+void readyQueueTests() {
+    //ranks above, inside and below a tiny run queue range -> same order as the default range, FIFO ties
+    SimOSConfig tiny;
+    tiny.scheduler.runQueueLow = 0;
+    tiny.scheduler.runQueueLevels = 4;
+    SimOS test (OS_DISKS, OS_RAM, OS_SIZE, tiny);              //1
+    SimOS wide (OS_DISKS, OS_RAM, OS_SIZE);                     //1
+    for (SimOS* sim : {&test, &wide}) {
+        sim->NewProcess(1000, 100);                             //2
+        sim->NewProcess(1000, 10);                              //3
+        sim->NewProcess(1000, 2);                               //4
+        sim->NewProcess(1000, 2);                               //5
+        sim->NewProcess(1000, 3);                               //6
+        sim->NewProcess(1000, -5);                              //7
+        sim->NewProcess(1000, 10);                              //8
+    }
+    bool result = (test.GetReadyQueue() == std::vector<int>{3, 8, 6, 4, 5, 1, 7}) &&
+                  (wide.GetReadyQueue() == test.GetReadyQueue());
+    std::vector<int> holders;
+    for (int i = 0; i < 6; ++i) {
+        test.SimExit();
+        holders.push_back(test.GetCPU());
+    }
+    result = result && holders == std::vector<int>{3, 8, 6, 4, 5, 1};
+
+    if (result) {
+        assert(result);
+        std::cout << "READY QUEUE TEST 1: PASS" << std::endl;
+    } else {
+        std::cout << "READY QUEUE TEST 1: FAIL" << std::endl;
+    }
+}
+
+void smpTests() {
+    bool placement = true;
+    bool stealing = true;
+    bool affinity = true;
+    bool crossCoreKill = true;
+    bool manyCores = true;
+
+    if (placement) {
+        //new processes spread over idle cores, one core behaves like the single CPU API
+        const char* path = "simos_smp_trace_test.bin";
+        SimOSConfig quad;
+        quad.cores = 4;
+        bool result = true;
+        {
+            TraceRecorder recorder (path, OS_DISKS, OS_RAM, OS_SIZE, quad);    //1
+            SimOS& test = recorder.sim();
+            for (int i = 0; i < 5; ++i) {
+                recorder.NewProcess(1000, 5);                   //2 3 4 5 -> cores 0-3, 6 -> core 0 queue
+            }
+            result = (test.GetCoreCount() == 4) &&
+                     (test.GetCPU(0) == 2) && (test.GetCPU(1) == 3) && (test.GetCPU(2) == 4) && (test.GetCPU(3) == 5) &&
+                     (test.GetReadyQueue(0) == std::vector<int>{6, 1}) && test.GetReadyQueue(1).empty() &&
+                     (test.GetCPU(4) == NO_PROCESS) && (test.GetCPU(-1) == NO_PROCESS);
+            recorder.SimExit();                                 //2 exits -> 6 on core 0
+            recorder.GetCPU();
+        }
+        TraceReplayer replayer (path);
+        auto stats = replayer.replay();
+        result = result && (replayer.header().cores == 4) && stats.complete && stats.mismatches == 0;
+        std::remove(path);
+
+        SimOSConfig single;
+        single.cores = 1;
+        SimOS one (OS_DISKS, OS_RAM, OS_SIZE, single);          //1
+        SimOS plain (OS_DISKS, OS_RAM, OS_SIZE);                //1
+        for (SimOS* sim : {&one, &plain}) {
+            sim->NewProcess(1000, 5);                           //2
+            sim->NewProcess(1000, 7);                           //3
+            sim->SimFork();                                     //4
+            sim->NewProcess(1000, 7);                           //5
+        }
+        result = result && (one.GetCoreCount() == 1) && (one.GetCPU(1) == NO_PROCESS) &&
+                 (one.GetCPU() == plain.GetCPU()) && (one.GetCPU(0) == 3) &&
+                 (one.GetReadyQueue() == plain.GetReadyQueue()) && (one.GetReadyQueue(0) == plain.GetReadyQueue());
+
+        if (result) {
+            assert(result);
+            std::cout << "SMP TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "SMP TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (stealing) {
+        //a core that runs dry takes the oldest unpinned process from a busy core
+        SimOSConfig dual;
+        dual.cores = 2;
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE, dual);           //1
+        for (int i = 0; i < 5; ++i) {
+            test.NewProcess(1000, 5);                           //2 core 0, 3 core 1, 4 5 6 queued alternately
+        }
+        bool result = (test.GetReadyQueue(0) == std::vector<int>{4, 6, 1}) && (test.GetReadyQueue(1) == std::vector<int>{5});
+        test.SimExit(1);                                        //3 exits -> 5
+        result = result && (test.GetCPU(1) == 5);
+        test.SimExit(1);                                        //5 exits -> steals 4 from core 0
+        result = result && (test.GetCPU(1) == 4) && (test.GetReadyQueue(0) == std::vector<int>{6, 1}) &&
+                 test.GetReadyQueue(1).empty();
+        test.SimExit(1);                                        //4 exits -> steals 6, never the OS
+        result = result && (test.GetCPU(1) == 6) && (test.GetReadyQueue(0) == std::vector<int>{1});
+        test.SimExit(1);
+        result = result && (test.GetCPU(1) == NO_PROCESS) && (test.GetCPU(0) == 2);
+
+        if (result) {
+            assert(result);
+            std::cout << "SMP TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "SMP TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (affinity) {
+        //pinned processes migrate right away and are never stolen
+        SimOSConfig dual;
+        dual.cores = 2;
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE, dual);           //1
+        test.NewProcess(1000, 5);                               //2 core 0
+        test.NewProcess(1000, 5);                               //3 core 1
+        bool result = !test.SetAffinity(1, 1) && !test.SetAffinity(99, 0) && !test.SetAffinity(2, 2);
+        result = result && test.SetAffinity(2, 1);              //2 leaves core 0, queues behind 3
+        result = result && (test.GetCPU(0) == 1) && (test.GetCPU(1) == 3) && (test.GetReadyQueue(1) == std::vector<int>{2});
+        test.NewProcess(1000, 5);                               //4 -> idle core 0
+        test.SimExit(0);                                        //4 exits -> core 0 does not take 2
+        result = result && (test.GetCPU(0) == 1) && (test.GetReadyQueue(1) == std::vector<int>{2});
+        test.DiskReadRequest(1, 0, "abc");                      //3 to disk 0 -> 2 runs on core 1
+        result = result && (test.GetCPU(1) == 2) && (test.GetDisk(0).PID == 3);
+        test.DiskJobCompleted(0);                               //3 wakes on core 0, its idle home core
+        result = result && (test.GetCPU(0) == 3) && (test.GetCPU(1) == 2);
+
+        //a pinned process ranked above the unpinned one is passed over
+        SimOS ranked (OS_DISKS, OS_RAM, OS_SIZE, dual);        //1
+        ranked.NewProcess(1000, 5);                             //2 core 0
+        ranked.NewProcess(1000, 5);                             //3 core 1
+        ranked.NewProcess(1000, 3);                             //4 queued on core 0
+        ranked.NewProcess(1000, 4);                             //5 queued on core 1
+        ranked.NewProcess(1000, 2);                             //6 queued on core 0
+        result = result && ranked.SetAffinity(4, 0) && (ranked.GetReadyQueue(0) == std::vector<int>{4, 6, 1});
+        ranked.SimExit(1);                                      //3 exits -> 5
+        ranked.SimExit(1);                                      //5 exits -> steals 6
+        result = result && (ranked.GetCPU(1) == 6) && (ranked.GetReadyQueue(0) == std::vector<int>{4, 1});
+
+        if (result) {
+            assert(result);
+            std::cout << "SMP TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "SMP TEST 3: FAIL" << std::endl;
+        }
+    }
+
+    if (crossCoreKill) {
+        //a parent exit takes down children running on other cores
+        SimOSConfig dual;
+        dual.cores = 2;
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE, dual);           //1
+        test.NewProcess(1000, 5);                               //2 core 0
+        test.SimFork();                                         //3 -> idle core 1
+        test.SimFork(1);                                        //4 child of 3, queued on core 1
+        bool result = (test.GetCPU(1) == 3) && (test.GetReadyQueue(1) == std::vector<int>{4});
+        test.SimWait(1);                                        //3 waits -> 4 runs
+        result = result && (test.GetCPU(1) == 4);
+        test.SimExit(0);                                        //2 exits -> 3 & 4 gone too
+        result = result && (test.GetCPU(0) == 1) && (test.GetCPU(1) == NO_PROCESS) &&
+                 test.GetReadyQueue(0).size() == 0 && test.GetReadyQueue(1).empty() && (test.GetMemory().size() == 1);
+
+        if (result) {
+            assert(result);
+            std::cout << "SMP TEST 4: PASS" << std::endl;
+        } else {
+            std::cout << "SMP TEST 4: FAIL" << std::endl;
+        }
+    }
+
+    if (manyCores) {
+        //hundreds of cores, every core drained through its own calls plus stealing
+        const int CORES = 256;
+        const int PROCESSES = 20'000;
+        SimOSConfig config;
+        config.cores = CORES;
+        SimOS test (OS_DISKS, OS_RAM, OS_SIZE, config);         //1
+        for (int i = 0; i < PROCESSES; ++i) {
+            test.NewProcess(1000, i % 7);
+        }
+        bool result = test.GetCoreCount() == CORES;
+        for (int core = 1; core < CORES; ++core) {
+            result = result && test.GetCPU(core) != NO_PROCESS && test.GetCPU(core) != 1;
+        }
+        int exits = 0;
+        for (int core = CORES - 1; core >= 0; --core) {
+            while (test.GetCPU(core) != NO_PROCESS && test.GetCPU(core) != 1) {
+                test.SimExit(core);
+                ++exits;
+            }
+        }
+        result = result && (exits == PROCESSES) && (test.GetMemory().size() == 1) && (test.GetCPU(0) == 1);
+
+        if (result) {
+            assert(result);
+            std::cout << "SMP TEST 5: PASS" << std::endl;
+        } else {
+            std::cout << "SMP TEST 5: FAIL" << std::endl;
+        }
+    }
+}
+
+//holds depth guards on this thread until release, full is set once they are all taken
+void pinGuards(ConcurrentSimOS& test, int depth, std::promise<void>& full, std::shared_future<void> release) {
+    if (depth == 0) {
+        full.set_value();
+        release.wait();
+        return;
+    }
+    auto snapshot = test.read();
+    pinGuards(test, depth - 1, full, release);
+}
+
+void concurrentTests() {
+    bool producers = true;
+    bool readers = true;
+    bool manyGuards = true;
+
+    if (producers) {
+        //4 threads submit at once, each thread's commands land in its own order
+        const int THREADS = 4;
+        const int PER_THREAD = 2000;
+        ConcurrentSimOS test (OS_DISKS, OS_RAM, OS_SIZE);           //1
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&test, t] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    //size encodes thread & sequence, no holes -> addresses grow in apply order
+                    test.post(SimCommand{static_cast<unsigned long long>(t * PER_THREAD + i + 1), 1, 0, CommandType::NEW_PROCESS});
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto fork = test.call(SimCommand{0, 0, 0, CommandType::FORK});
+        auto cpu = test.call(SimCommand{0, 0, 0, CommandType::GET_CPU});
+        test.post(SimCommand{0, 0, 0, CommandType::DISK_READ}, "abc");
+        test.sync();
+
+        auto snapshot = test.read();
+        bool result = (fork.get() == 1) && (cpu.get() == 2) && 
+                      (snapshot->applied == THREADS * PER_THREAD + 3) &&
+                      (snapshot->memory.size() == 1 + THREADS * PER_THREAD + 1) &&
+                      (snapshot->disks[0].PID == 2) && (snapshot->disks[0].fileName == "abc") &&
+                      (snapshot->cpus[0] == 3);
+        std::vector<unsigned long long> lastAddress (THREADS, 0);
+        for (auto& item : snapshot->memory) {
+            if (item.PID == 1 || item.PID == THREADS * PER_THREAD + 2) {
+                continue;
+            }
+            int thread = static_cast<int>((item.itemSize - 1) / PER_THREAD);
+            result = result && item.itemAddress > lastAddress[thread];
+            lastAddress[thread] = item.itemAddress;
+        }
+
+        if (result) {
+            assert(result);
+            std::cout << "CONCURRENT TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "CONCURRENT TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (readers) {
+        //readers hammer snapshots while the owner applies, every snapshot is self consistent
+        ConcurrentSimOS test (OS_DISKS, OS_RAM, OS_SIZE);           //1
+        std::atomic<bool> done {false};
+        std::atomic<bool> consistent {true};
+        std::atomic<unsigned long long> reads {0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 3; ++t) {
+            threads.emplace_back([&] {
+                unsigned long long lastVersion = 0;
+                while (!done.load()) {
+                    auto snapshot = test.read();
+                    bool ok = snapshot->version >= lastVersion && !snapshot->memory.empty() &&
+                              snapshot->memory.front().PID == 1;
+                    for (int pid : snapshot->readyQueues[0]) {
+                        ok = ok && pid != snapshot->cpus[0];
+                    }
+                    lastVersion = snapshot->version;
+                    if (!ok) {
+                        consistent.store(false);
+                    }
+                    ++reads;
+                }
+            });
+        }
+        for (int i = 0; i < 3000; ++i) {
+            test.post(SimCommand{1000, i % 5, 0, CommandType::NEW_PROCESS});
+            if (i % 3 == 2) {
+                test.post(SimCommand{0, 0, 0, CommandType::EXIT});
+            }
+        }
+        test.sync();
+        done.store(true);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto snapshot = test.read();
+        bool result = consistent.load() && reads.load() > 0 && (snapshot->memory.size() == 1 + 3000 - 1000);
+
+        if (result) {
+            assert(result);
+            std::cout << "CONCURRENT TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "CONCURRENT TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (manyGuards) {
+        //every reader slot taken -> the next guard goes to the overflow slot and alone keeps its snapshot alive
+        ConcurrentSimOS test (OS_DISKS, OS_RAM, OS_SIZE);           //1
+        std::promise<void> full;
+        std::promise<void> release;
+        std::thread holder (pinGuards, std::ref(test), 64, std::ref(full), release.get_future().share());
+        full.get_future().wait();
+        bool result;
+        {
+            auto snapshot = test.read();
+            release.set_value();
+            holder.join();
+            for (int i = 0; i < 4; ++i) {
+                test.post(SimCommand{1000, 1, 0, CommandType::NEW_PROCESS});
+                test.sync();
+            }
+            result = (snapshot->version == 0) && (snapshot->memory.size() == 1) && (snapshot->memory.front().PID == 1);
+        }
+        test.post(SimCommand{1000, 1, 0, CommandType::NEW_PROCESS});
+        test.sync();
+        result = result && (test.read()->memory.size() == 1 + 5);
+
+        if (result) {
+            assert(result);
+            std::cout << "CONCURRENT TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "CONCURRENT TEST 3: FAIL" << std::endl;
+        }
+    }
+}
+
+void sweepTests() {
+    //one trace, many machines: 1 thread and 4 threads agree, the recorded machine replays exactly
+    const char* path = "simos_sweep_trace_test.bin";
+    const char* resultsPath = "simos_sweep_results_test.bin";
+    WorkloadConfig workload = fragmentationWorkload(7, 5000);
+    {
+        TraceRecorder recorder (path, workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+        WorkloadGenerator generator (workload);
+        generator.run(recorder);
+    }
+    TraceReplayer trace (path);
+
+    std::vector<SweepConfig> configs;
+    for (int disks = 1; disks <= workload.numberOfDisks; ++disks) {
+        for (int scale = 1; scale <= 4; ++scale) {
+            for (auto placement : {PlacementType::WORST_FIT, PlacementType::FIRST_FIT, PlacementType::BEST_FIT}) {
+                SweepConfig config {disks, workload.amountOfRAM * scale / 2, workload.sizeOfOS, workload.sim};
+                config.sim.placement = placement;
+                configs.push_back(config);
+            }
+        }
+    }
+    configs.push_back(SweepConfig{workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim});
+
+    SweepRunner serial (trace, configs);
+    SweepRunner parallel (trace, configs);
+    auto& one = serial.run(1);
+    auto& four = parallel.run(4);
+    bool result = trace.valid() && parallel.write(resultsPath);
+    for (size_t i = 0; i < configs.size(); ++i) {
+        result = result && one[i].replay.complete && four[i].replay.complete &&
+                 one[i].replay.calls == 5000 && one[i].replay.mismatches == four[i].replay.mismatches &&
+                 one[i].replay.admitted == four[i].replay.admitted && one[i].resident == four[i].resident &&
+                 one[i].usedRAM == four[i].usedRAM && one[i].largestHole == four[i].largestHole;
+    }
+    result = result && one.back().replay.mismatches == 0 &&
+             one.front().replay.rejected > one[configs.size() - 2].replay.rejected;     //half the RAM rejects more than double
+
+    //fixed fields are little endian whatever the host: version 1, then the row count low byte first
+    std::ifstream raw (resultsPath, std::ios::binary);
+    std::vector<unsigned char> head (20);
+    raw.read(reinterpret_cast<char*>(head.data()), 20);
+    result = result && raw && head[8] == 1 && head[9] == 0 && head[10] == 0 && head[11] == 0 &&
+             head[12] == (configs.size() & 0xff) && head[13] == ((configs.size() >> 8) & 0xff) && head[19] == 0;
+    raw.close();
+
+    auto columns = readSweepColumns(resultsPath);
+    result = result && columns.size() == 19 && columns[1].name == "ram" && columns.back().real &&
+             columns.back().reals.size() == configs.size();
+    for (auto& column : columns) {
+        if (column.name == "admitted") {
+            for (size_t i = 0; i < configs.size(); ++i) {
+                result = result && column.integers[i] == four[i].replay.admitted;
+            }
+        }
+    }
+
+    //a row count whose 8 bytes per row wrap around to one row is refused, not read past the end
+    const char* corruptPath = "simos_sweep_corrupt_test.bin";
+    std::ifstream whole (resultsPath, std::ios::binary);
+    std::vector<char> bytes ((std::istreambuf_iterator<char>(whole)), std::istreambuf_iterator<char>());
+    whole.close();
+    std::uint64_t wrapped = (1ULL << 61) + 1;
+    for (int i = 0; i < 8 && bytes.size() >= 20; ++i) {
+        bytes[12 + i] = static_cast<char>((wrapped >> (8 * i)) & 0xff);
+    }
+    std::ofstream corrupt (corruptPath, std::ios::binary);
+    corrupt.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    corrupt.close();
+    result = result && bytes.size() >= 20 && readSweepColumns(corruptPath).empty();
+
+    std::remove(path);
+    std::remove(resultsPath);
+    std::remove(corruptPath);
+
+    if (result) {
+        assert(result);
+        std::cout << "SWEEP TEST 1: PASS" << std::endl;
+    } else {
+        std::cout << "SWEEP TEST 1: FAIL" << std::endl;
+    }
+}
+
+//head at 53, queue 98 183 37 122 14 124 65 67 -> service order (PIDs) and total seek
+std::vector<int> diskOrder(DiskPolicyType policy, unsigned long long& seek, unsigned long long& expired) {
+    SimOSConfig config;
+    config.disks.policy = policy;
+    config.disks.deadline = 3;
+    SimOS test (1, OS_RAM, OS_SIZE, config);                    //1
+    std::vector<unsigned long long> blocks {53, 98, 183, 37, 122, 14, 124, 65, 67};
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        test.NewProcess(1000, 5);                               //2 .. 10
+    }
+    for (auto block : blocks) {
+        test.DiskReadRequest(0, "file", block);                 //2 served at once, 3 .. 10 queue
+    }
+    std::vector<int> order;
+    while (test.GetDisk(0).PID != 0) {
+        test.DiskJobCompleted(0);
+        if (test.GetDisk(0).PID != 0) {
+            order.push_back(test.GetDisk(0).PID);
+        }
+    }
+    seek = test.GetDiskStats(0).seekDistance;
+    expired = test.GetDiskStats(0).expired;
+    return order;
+}
+
+void diskPolicyTests() {
+    bool textbook = true;
+    bool deepQueue = true;
+    bool traced = true;
+
+    if (textbook) {
+        unsigned long long seek[5] {}, expired[5] {};
+        bool result = (
+            diskOrder(DiskPolicyType::FIFO, seek[0], expired[0]) == std::vector<int>{3, 4, 5, 6, 7, 8, 9, 10} &&
+            diskOrder(DiskPolicyType::SSTF, seek[1], expired[1]) == std::vector<int>{9, 10, 5, 7, 3, 6, 8, 4} &&
+            diskOrder(DiskPolicyType::SCAN, seek[2], expired[2]) == std::vector<int>{9, 10, 3, 6, 8, 4, 5, 7} &&
+            diskOrder(DiskPolicyType::C_LOOK, seek[3], expired[3]) == std::vector<int>{9, 10, 3, 6, 8, 4, 7, 5} &&
+            diskOrder(DiskPolicyType::DEADLINE, seek[4], expired[4]) == std::vector<int>{9, 10, 3, 4, 5, 6, 7, 8}
+        );
+        //53 to reach the first request from block 0
+        result = result && seek[0] == 53 + 640 && seek[1] == 53 + 236 && seek[2] == 53 + 299 && seek[3] == 53 + 322;
+        result = result && expired[4] == 5 && expired[0] == 0;
+
+        if (result) {
+            assert(result);
+            std::cout << "DISK POLICY TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "DISK POLICY TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (deepQueue) {
+        //20000 queued reads: seek-aware policies cut the seek distance, kills drop indexed requests
+        const int READS = 20'000;
+        const unsigned long long BLOCKS = 1'000'000;
+        unsigned long long seeks[3] {};
+        bool result = true;
+        int slot = 0;
+        for (auto policy : {DiskPolicyType::FIFO, DiskPolicyType::SSTF, DiskPolicyType::C_LOOK}) {
+            SimOSConfig config;
+            config.disks.policy = policy;
+            SimOS test (2, OS_RAM, OS_SIZE, config);            //1
+            Random random (11);
+            for (int i = 0; i < READS; ++i) {
+                test.NewProcess(1000, 5);
+            }
+            for (int i = 0; i < READS; ++i) {
+                test.DiskReadRequest(0, "file", random.uniform(0, BLOCKS - 1), 4);
+            }
+            //a parent exit drops its queued child from the middle of the indexed queue
+            test.NewProcess(1000, 5);
+            test.SimFork();
+            int parent = test.GetCPU();
+            test.DiskReadRequest(1, "parent");                  //parent parks on disk 1
+            result = result && test.GetCPU() == parent + 1;
+            test.DiskReadRequest(0, "child", BLOCKS / 2, 4);
+            result = result && test.ViewDiskQueue(0).size() == READS;
+            test.DiskJobCompleted(1);
+            result = result && test.GetCPU() == parent;
+            test.SimExit();
+            result = result && test.ViewDiskQueue(0).size() == READS - 1;
+
+            size_t served = 0;
+            while (test.GetDisk(0).PID != 0) {
+                test.DiskJobCompleted(0);
+                ++served;
+            }
+            result = result && served == READS && test.GetDiskStats(0).dispatched == READS;
+            seeks[slot++] = test.GetDiskStats(0).seekDistance;
+        }
+        result = result && seeks[1] * 10 < seeks[0] && seeks[2] * 10 < seeks[0];
+
+        if (result) {
+            assert(result);
+            std::cout << "DISK POLICY TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "DISK POLICY TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (traced) {
+        //block addresses and the disk policy survive a trace round trip
+        const char* path = "simos_disk_policy_test.bin";
+        WorkloadConfig workload = fragmentationWorkload(3, 10000);
+        workload.diskBlocks = 4096;
+        workload.sim.disks.policy = DiskPolicyType::SCAN;
+        {
+            TraceRecorder recorder (path, workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+            WorkloadGenerator generator (workload);
+            generator.run(recorder);
+        }
+        SimOS live (workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+        WorkloadGenerator generator (workload);
+        generator.run(live);
+
+        TraceReplayer replayer (path);
+        auto stats = replayer.replay();
+        SimOS replayed (workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+        replayer.replay(replayed, false);
+        std::remove(path);
+        bool result = replayer.header().diskPolicy == static_cast<std::uint32_t>(DiskPolicyType::SCAN) &&
+                      stats.complete && stats.mismatches == 0 && sameState(live, replayed) &&
+                      live.GetDiskStats(0).seekDistance == replayed.GetDiskStats(0).seekDistance &&
+                      live.GetDiskStats(0).seekDistance > 0;
+
+        //a policy per disk is recorded too
+        workload = fragmentationWorkload(3, 20000);
+        workload.diskBlocks = 4096;
+        workload.sim.disks.perDisk = {DiskPolicyType::SSTF, DiskPolicyType::FIFO};
+        {
+            TraceRecorder recorder (path, workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+            WorkloadGenerator perDisk (workload);
+            perDisk.run(recorder);
+        }
+        TraceReplayer perDiskReplayer (path);
+        stats = perDiskReplayer.replay();
+        std::remove(path);
+        result = result && perDiskReplayer.header().perDisk.size() == 2 &&
+                 perDiskReplayer.header().perDisk[0] == static_cast<std::uint32_t>(DiskPolicyType::SSTF) &&
+                 stats.complete && stats.calls == 20000 && stats.mismatches == 0;
+
+        if (result) {
+            assert(result);
+            std::cout << "DISK POLICY TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "DISK POLICY TEST 3: FAIL" << std::endl;
+        }
+    }
+}
+
+std::vector<int> PIDsOf(std::queue<FileReadRequest> queue) {
+    std::vector<int> PIDs;
+    for (; !queue.empty(); queue.pop()) {
+        PIDs.push_back(queue.front().PID);
+    }
+    return PIDs;
+}
+
+void diskMergeTests() {
+    bool sameFile = true;
+    bool adjacentBlocks = true;
+    bool swapTraffic = true;
+
+    if (sameFile) {
+        //queued reads of one file ride on one job and wake together
+        SimOSConfig config;
+        config.disks.merge = true;
+        SimOS test (1, OS_RAM, OS_SIZE, config);                //1
+        for (int i = 0; i < 5; ++i) {
+            test.NewProcess(1000, 5);                           //2 .. 6
+        }
+        test.DiskReadRequest(0, "a");                           //2 in service
+        test.DiskReadRequest(0, "b");                           //3 queued job b
+        test.DiskReadRequest(0, "a");                           //4 queued job a (2 is already reading)
+        test.DiskReadRequest(0, "b");                           //5 joins job b
+        test.DiskReadRequest(0, "a");                           //6 joins job a
+        bool result = PIDsOf(test.GetDiskQueue(0)) == std::vector<int>{3, 5, 4, 6} &&
+                      test.GetDiskStats(0).merged == 2 && test.GetCPU() == 1;
+        test.DiskJobCompleted(0);                               //2 back, job b starts
+        result = result && test.GetDisk(0).PID == 3 && PIDsOf(test.GetDiskQueue(0)) == std::vector<int>{4, 6};
+        test.DiskJobCompleted(0);                               //3 & 5 back, job a starts
+        result = result && test.GetCPU() == 2 && test.GetReadyQueue() == std::vector<int>{3, 5, 1} &&
+                 test.GetDisk(0).PID == 4 && test.GetDiskQueue(0).empty();
+        test.DiskJobCompleted(0);                               //4 & 6 back
+        result = result && test.GetReadyQueue() == std::vector<int>{3, 5, 4, 6, 1} &&
+                 test.GetDisk(0).PID == 0 && test.GetDiskStats(0).dispatched == 3;
+
+        //the merge flag survives a trace round trip
+        const char* path = "simos_disk_merge_test.bin";
+        WorkloadConfig workload = fragmentationWorkload(5, 10000);
+        workload.fileCount = 3;
+        workload.sim.disks.merge = true;
+        size_t merged = 0;
+        {
+            TraceRecorder recorder (path, workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+            WorkloadGenerator generator (workload);
+            generator.run(recorder);
+            for (int disk = 0; disk < workload.numberOfDisks; ++disk) {
+                merged += recorder.sim().GetDiskStats(disk).merged;
+            }
+        }
+        TraceReplayer replayer (path);
+        auto stats = replayer.replay();
+        std::remove(path);
+        result = result && merged > 0 && stats.complete && stats.mismatches == 0;
+
+        if (result) {
+            assert(result);
+            std::cout << "DISK MERGE TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "DISK MERGE TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (adjacentBlocks) {
+        //touching block ranges merge, a killed leader hands the running job to its rider
+        SimOSConfig config;
+        config.disks.merge = true;
+        SimOS test (2, OS_RAM, OS_SIZE, config);                //1
+        test.NewProcess(1000, 5);                               //2 P
+        test.NewProcess(1000, 5);                               //3 Q
+        test.SimFork();                                         //4 C child of P
+        test.NewProcess(1000, 5);                               //5 R
+        test.DiskReadRequest(1, "p");                           //P parks on disk 1
+        test.DiskReadRequest(0, "q", 500, 10);                  //Q in service [500, 510)
+        test.DiskReadRequest(0, "c", 100, 10);                  //C queued [100, 110)
+        test.DiskReadRequest(0, "r", 110, 5);                   //R touches C -> same job [100, 115)
+        bool result = PIDsOf(test.GetDiskQueue(0)) == std::vector<int>{4, 5} && test.GetDiskStats(0).merged == 1;
+        test.DiskJobCompleted(0);                               //Q back, job C starts
+        test.DiskJobCompleted(1);                               //P back
+        result = result && test.GetDisk(0).PID == 4 && test.GetCPU() == 3;
+        test.SimExit();                                         //Q exits -> P
+        test.SimExit();                                         //P exits -> C dies, R leads the job
+        result = result && test.GetDisk(0).PID == 5 && test.GetDisk(0).fileName == "r" && test.GetCPU() == 1;
+        test.DiskJobCompleted(0);
+        result = result && test.GetCPU() == 5 && test.GetDisk(0).PID == 0 && test.GetMemory().size() == 2 &&
+                 test.GetDiskStats(0).dispatched == 2 && test.GetDiskStats(0).seekDistance == 500 + 410;
+
+        if (result) {
+            assert(result);
+            std::cout << "DISK MERGE TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "DISK MERGE TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (swapTraffic) {
+        //swap writes of different processes, and a user file that happens to be called "swap", never merge
+        SimOSConfig config;
+        config.disks.merge = true;
+        config.swap.disk = 0;
+        SimOS test (1, 1000, 100, config);                      //1
+        test.NewProcess(300, 5);                                //2 [100, 400) runs
+        test.NewProcess(200, 1);                                //3 [400, 600)
+        test.NewProcess(200, 1);                                //4 [600, 800)
+        test.NewProcess(200, 1);                                //5 [800, 1000)
+        test.DiskReadRequest(0, "x");                           //2 in service, 3 runs
+        test.NewProcess(300, 9);                                //6, 4 & 5 swapped out
+        test.NewProcess(100, 9);                                //7 in the rest
+        bool result = test.GetCPU() == 6 && PIDsOf(test.GetDiskQueue(0)) == std::vector<int>{4, 5} &&
+                      test.GetSwapStats().swapOuts == 2;
+        test.DiskReadRequest(0, "swap");                        //6 queues on its own
+        result = result && PIDsOf(test.GetDiskQueue(0)) == std::vector<int>{4, 5, 6} && test.GetDiskStats(0).merged == 0;
+        test.DiskJobCompleted(0);                               //2 back, 4 written out alone
+        result = result && test.GetDisk(0).PID == 4 && PIDsOf(test.GetDiskQueue(0)) == std::vector<int>{5, 6};
+        test.DiskJobCompleted(0);
+        test.DiskJobCompleted(0);
+        result = result && test.GetDisk(0).PID == 6 && test.GetDiskStats(0).dispatched == 4;
+
+        if (result) {
+            assert(result);
+            std::cout << "DISK MERGE TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "DISK MERGE TEST 3: FAIL" << std::endl;
+        }
+    }
+}
+
+//touch address in the running process, a swap in on disk 0 completes right away
+void touch(SimOS& test, unsigned long long address) {
+    int PID = test.GetCPU();
+    test.AccessMemory(address);
+    if (test.GetCPU() != PID) {
+        test.DiskJobCompleted(0);
+    }
+}
+
+//4 page process in 3 user frames, pages 0 1 2 mapped at admission, then 0 3 0 1 0 2
+MemoryStats pagingRun(ReplacementType replacement) {
+    SimOSConfig config;
+    config.memory.paged = true;
+    config.memory.pageSize = 100;
+    config.memory.replacement = replacement;
+    config.memory.swapDisk = 0;
+    config.memory.window = 3;
+    config.memory.agingInterval = 1;
+    SimOS test (1, 400, 100, config);                           //1
+    test.NewProcess(400, 5);                                    //2
+    for (int page : {0, 3, 0, 1, 0, 2}) {
+        touch(test, page * 100 + 50);
+    }
+    return test.GetMemoryStats();
+}
+
+void pagingTests() {
+    bool fragmentation = true;
+    bool replacement = true;
+    bool swapIn = true;
+    bool traceRoundTrip = true;
+
+    if (fragmentation) {
+        //300 + 200 free bytes apart: contiguous rejects 400, paged scatters it over the free frames
+        SimOSConfig config;
+        config.memory.paged = true;
+        config.memory.pageSize = 100;
+        SimOS contiguous (1, 1000, 100);                        //1
+        SimOS paged (1, 1000, 100, config);                     //1
+        bool result = true;
+        for (SimOS* test : {&contiguous, &paged}) {
+            test->NewProcess(200, 1);                           //2
+            test->NewProcess(200, 5);                           //3 runs
+            test->NewProcess(200, 1);                           //4
+            test->NewProcess(200, 4);                           //5
+            test->SimExit();                                    //3 exits -> 5
+            test->SimExit();                                    //5 exits -> 2
+            result = result && test->GetCPU() == 2;
+        }
+        result = result && !contiguous.NewProcess(400, 1) && paged.NewProcess(400, 1) &&   //6
+                 !paged.NewProcess(200, 1) && contiguous.GetMemoryStats().faults == 0;
+
+        //runs of frames, ordered by address
+        auto memory = paged.GetMemory();
+        std::vector<std::tuple<unsigned long long, unsigned long long, int>> runs;
+        for (auto& item : memory) {
+            runs.emplace_back(item.itemAddress, item.itemSize, item.PID);
+        }
+        result = result && runs == decltype(runs){{0, 100, 1}, {100, 200, 2}, {300, 200, 6}, {500, 200, 4}, {700, 200, 6}};
+        paged.SimExit();                                        //2 exits, frames 1-2 free up
+        result = result && paged.NewProcess(300, 1) && paged.GetMemory().size() == 6;   //7 -> frames 1-2 and 9
+
+        if (result) {
+            assert(result);
+            std::cout << "PAGING TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "PAGING TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (replacement) {
+        //FIFO and CLOCK (all reference bits set) throw out page 0 first, LRU / working set keep it
+        auto fifo = pagingRun(ReplacementType::FIFO);
+        auto clock = pagingRun(ReplacementType::CLOCK);
+        auto lru = pagingRun(ReplacementType::LRU);
+        auto workingSet = pagingRun(ReplacementType::WORKING_SET);
+        bool result = fifo.accesses == 6 && fifo.faults == 4 && fifo.majorFaults == 3 && fifo.evictions == 4 &&
+                      clock.faults == 4 && clock.majorFaults == 3 && clock.evictions == 4 &&
+                      lru.faults == 3 && lru.majorFaults == 2 && lru.evictions == 3 &&
+                      workingSet.faults == 3 && workingSet.majorFaults == 2 && workingSet.evictions == 3 &&
+                      fifo.swappedPages == 1 && lru.swappedPages == 1;
+
+        if (result) {
+            assert(result);
+            std::cout << "PAGING TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "PAGING TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (swapIn) {
+        //a page read back from swap blocks its process on the swap disk
+        SimOSConfig config;
+        config.memory.paged = true;
+        config.memory.pageSize = 100;
+        config.memory.swapDisk = 1;
+        SimOS test (2, 400, 100, config);                       //1
+        test.NewProcess(300, 5);                                //2 frames 1-3
+        test.NewProcess(200, 1);                                //3 no frame left, demand zero
+        bool result = test.AccessMemory(0) && !test.AccessMemory(300) && test.GetMemoryStats().faults == 0;
+        test.DiskReadRequest(0, "a");                           //2 waits -> 3 runs
+        test.AccessMemory(150);                                 //3 page 1 takes 2's page 0 (slot 0)
+        test.AccessMemory(0);                                   //3 page 0 takes 2's page 1 (slot 1)
+        result = result && test.GetCPU() == 3 && test.GetMemoryStats().majorFaults == 0;
+        test.DiskJobCompleted(0);                               //2 back, preempts 3
+        test.AccessMemory(50);                                  //2 page 0 from slot 0, its page 2 goes to slot 0
+        auto stats = test.GetMemoryStats();
+        auto disk = test.GetDisk(1);
+        result = result && test.GetCPU() == 3 && disk.PID == 2 && disk.fileName == "swap" && disk.block == 0 &&
+                 stats.faults == 3 && stats.majorFaults == 1 && stats.evictions == 3 && stats.swappedPages == 2;
+        auto memory = test.GetMemory();
+        result = result && memory.size() == 3 && memory[1].PID == 3 && memory[1].itemSize == 200 &&
+                 memory[2].PID == 2 && memory[2].itemAddress == 300;
+        test.DiskJobCompleted(1);                               //2 back
+        result = result && test.GetCPU() == 2 && test.AccessMemory(50) && test.GetMemoryStats().faults == 3;
+        test.SimExit();                                         //2's frame and swap slots free up
+        result = result && test.GetMemoryStats().swappedPages == 0 && test.GetMemory().size() == 2 && test.GetCPU() == 3;
+
+        if (result) {
+            assert(result);
+            std::cout << "PAGING TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "PAGING TEST 3: FAIL" << std::endl;
+        }
+    }
+
+    if (traceRoundTrip) {
+        //paged workload with accesses records and replays exactly
+        const char* path = "simos_paging_test.bin";
+        WorkloadConfig workload = fragmentationWorkload(11, 20000);
+        workload.amountOfRAM = 1ULL << 22;
+        workload.accessWeight = 8;
+        workload.sim.memory.paged = true;
+        workload.sim.memory.replacement = ReplacementType::CLOCK;
+        workload.sim.memory.swapDisk = 1;
+        MemoryStats recorded;
+        WorkloadStats calls;
+        {
+            TraceRecorder recorder (path, workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+            WorkloadGenerator generator (workload);
+            calls = generator.run(recorder);
+            recorded = recorder.sim().GetMemoryStats();
+        }
+        TraceReplayer replayer (path);
+        auto stats = replayer.replay();
+        std::remove(path);
+        bool result = replayer.header().memory == (TRACE_MEMORY_PAGED | static_cast<std::uint32_t>(ReplacementType::CLOCK)) &&
+                      stats.complete && stats.mismatches == 0 && calls.accesses > 0 &&
+                      recorded.accesses == calls.accesses && recorded.majorFaults > 0 && recorded.evictions > 0;
+
+        if (result) {
+            assert(result);
+            std::cout << "PAGING TEST 4: PASS" << std::endl;
+        } else {
+            std::cout << "PAGING TEST 4: FAIL" << std::endl;
+        }
+    }
+}
+
+std::vector<std::tuple<unsigned long long, unsigned long long, int>> itemsOf(const MemoryUse& memory) {
+    std::vector<std::tuple<unsigned long long, unsigned long long, int>> items;
+    for (auto& item : memory) {
+        items.emplace_back(item.itemAddress, item.itemSize, item.PID);
+    }
+    return items;
+}
+
+bool sameUsage(const MemoryUsage& usage, unsigned long long sharedBytes, unsigned long long privateBytes) {
+    return usage.sharedBytes == sharedBytes && usage.privateBytes == privateBytes;
+}
+
+void copyOnWriteTests() {
+    bool contiguousRegion = true;
+    bool pagedFrames = true;
+    bool traceRoundTrip = true;
+
+    if (contiguousRegion) {
+        //forks share the parent's region, a write moves the writer to a copy of its own
+        SimOS plain (1, 1000, 100);                             //1
+        plain.NewProcess(300, 5);                               //2
+        bool result = plain.SimFork() && plain.SimFork() && !plain.SimFork();
+
+        SimOSConfig config;
+        config.memory.copyOnWrite = true;
+        SimOS test (1, 1000, 100, config);                      //1
+        test.NewProcess(300, 5);                                //2 [100, 400)
+        for (int i = 0; i < 4; ++i) {
+            result = result && test.SimFork();                  //3 .. 6 share it
+        }
+        result = result && test.GetMemory().size() == 2 && sameUsage(test.GetMemoryUsage(5), 300, 0) &&
+                 test.GetMemoryStats().sharedBytes == 300 && test.GetMemoryStats().privateBytes == 100;
+        result = result && test.WriteMemory(10) && test.WriteMemory(20);   //2 -> [400, 700), one copy
+        result = result && itemsOf(test.GetMemory()) == decltype(itemsOf(MemoryUse{})){{0, 100, 1}, {100, 300, 6}, {400, 300, 2}} &&
+                 sameUsage(test.GetMemoryUsage(2), 0, 300) && sameUsage(test.GetMemoryUsage(3), 300, 0) &&
+                 test.GetMemoryStats().cowCopies == 1 && test.GetMemoryStats().privateBytes == 400;
+
+        test.DiskReadRequest(0, "a");                           //2 waits -> 3
+        result = result && test.WriteMemory(0) && !test.WriteMemory(300);  //3 -> [700, 1000)
+        test.SimExit();                                         //3 zombie, its copy goes
+        test.SimExit();                                         //4 leaves the region
+        test.SimExit();                                         //5 leaves it, 6 owns it alone
+        auto stats = test.GetMemoryStats();
+        result = result && test.GetCPU() == 6 && stats.cowCopies == 2 && stats.sharedBytes == 0 && stats.privateBytes == 700 &&
+                 sameUsage(test.GetMemoryUsage(6), 0, 300) && sameUsage(test.GetMemoryUsage(3), 0, 0) &&
+                 itemsOf(test.GetMemory()) == decltype(itemsOf(MemoryUse{})){{0, 100, 1}, {100, 300, 6}, {400, 300, 2}};
+
+        //no room for a copy -> the write fails and the region stays shared
+        result = result && test.NewProcess(300, 1) && test.SimFork() && !test.WriteMemory(0) &&   //7 [700, 1000), 8 child of 6
+                 sameUsage(test.GetMemoryUsage(6), 300, 0) && test.GetMemoryStats().cowCopies == 2;
+
+        if (result) {
+            assert(result);
+            std::cout << "COPY ON WRITE TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "COPY ON WRITE TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (pagedFrames) {
+        //paged: pages are shared one by one, a write copies only the page written
+        SimOSConfig config;
+        config.memory.paged = true;
+        config.memory.pageSize = 100;
+        config.memory.copyOnWrite = true;
+        SimOS test (1, 600, 100, config);                       //1 frame 0, frames 1-5 for users, no swap
+        test.NewProcess(300, 5);                                //2 frames 1-3
+        bool result = test.SimFork() && itemsOf(test.GetMemory()) == decltype(itemsOf(MemoryUse{})){{0, 100, 1}, {100, 300, 2}} &&
+                      sameUsage(test.GetMemoryUsage(3), 300, 0);    //3 shares 1-3
+        result = result && test.WriteMemory(150);               //2 page 1 -> frame 4, frame 2 listed under 3
+        result = result && itemsOf(test.GetMemory()) == decltype(itemsOf(MemoryUse{})){{0, 100, 1}, {100, 100, 2}, {200, 100, 3}, {300, 200, 2}} &&
+                 sameUsage(test.GetMemoryUsage(2), 200, 100) && sameUsage(test.GetMemoryUsage(3), 200, 100);
+        result = result && test.WriteMemory(250) && !test.WriteMemory(50) && test.AccessMemory(50);  //page 2 -> frame 5, page 0 doesn't fit
+        auto stats = test.GetMemoryStats();
+        result = result && stats.cowCopies == 2 && stats.sharedBytes == 100 && stats.privateBytes == 500 && stats.faults == 0 &&
+                 itemsOf(test.GetMemory()) == decltype(itemsOf(MemoryUse{})){{0, 100, 1}, {100, 100, 2}, {200, 200, 3}, {400, 200, 2}};
+
+        test.DiskReadRequest(0, "a");                           //2 waits -> 3
+        test.SimExit();                                         //3 zombie, page 0 is 2's alone now
+        stats = test.GetMemoryStats();
+        result = result && stats.sharedBytes == 0 && stats.privateBytes == 400 && sameUsage(test.GetMemoryUsage(2), 0, 300) &&
+                 itemsOf(test.GetMemory()) == decltype(itemsOf(MemoryUse{})){{0, 100, 1}, {100, 100, 2}, {400, 200, 2}};
+
+        if (result) {
+            assert(result);
+            std::cout << "COPY ON WRITE TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "COPY ON WRITE TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (traceRoundTrip) {
+        //fork heavy workloads with writes replay exactly, contiguous and paged with swap
+        const char* path = "simos_cow_test.bin";
+        WorkloadConfig contiguous = forkBombWorkload(3, 20000);
+        contiguous.amountOfRAM = 1ULL << 16;
+        WorkloadConfig paged = fragmentationWorkload(13, 20000);
+        paged.amountOfRAM = 1ULL << 22;
+        paged.forkWeight = 3;
+        paged.sim.memory.paged = true;
+        paged.sim.memory.swapDisk = 1;
+        paged.sim.memory.replacement = ReplacementType::CLOCK;
+        bool result = true;
+        for (WorkloadConfig* workload : {&contiguous, &paged}) {
+            workload->sim.memory.copyOnWrite = true;
+            workload->accessWeight = 2;
+            workload->writeWeight = 4;
+            MemoryStats recorded;
+            {
+                TraceRecorder recorder (path, workload->numberOfDisks, workload->amountOfRAM, workload->sizeOfOS, workload->sim);
+                WorkloadGenerator generator (*workload);
+                generator.run(recorder);
+                recorded = recorder.sim().GetMemoryStats();
+            }
+            TraceReplayer replayer (path);
+            auto stats = replayer.replay();
+            std::remove(path);
+            //everything held fits in RAM (+ as much swap)
+            auto capacity = workload->amountOfRAM * (workload->sim.memory.paged ? 2 : 1);
+            result = result && (replayer.header().memory & TRACE_MEMORY_COW) != 0 && stats.complete && stats.mismatches == 0 &&
+                     stats.forks > 0 && recorded.cowCopies > 0 && recorded.sharedBytes > 0 &&
+                     recorded.sharedBytes + recorded.privateBytes <= capacity;
+        }
+
+        if (result) {
+            assert(result);
+            std::cout << "COPY ON WRITE TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "COPY ON WRITE TEST 3: FAIL" << std::endl;
+        }
+    }
+}
+
+//holes [100, 200), [500, 550), [750, 900) around 1 (OS), 3 [200, 500), 5 [550, 750), 7 [900, 1000)
+void fragmentRAM(SimOS& test) {
+    test.NewProcess(100, 9);                                    //2
+    test.NewProcess(300, 1);                                    //3
+    test.NewProcess(50, 8);                                     //4
+    test.NewProcess(200, 1);                                    //5
+    test.NewProcess(150, 7);                                    //6
+    test.NewProcess(100, 1);                                    //7
+    test.SimExit();                                             //2
+    test.SimExit();                                             //4
+    test.SimExit();                                             //6, 3 runs
+}
+
+void compactionTests() {
+    bool modes = true;
+    bool sharedRegion = true;
+    bool traceRoundTrip = true;
+
+    if (modes) {
+        //300 bytes free, no hole holds 200
+        using Items = decltype(itemsOf(MemoryUse{}));
+        SimOSConfig config;
+        config.placement = PlacementType::FIRST_FIT;
+        SimOS none (1, 1000, 100, config);
+        fragmentRAM(none);
+        bool result = !none.NewProcess(200, 1) && none.GetCompactionStats().compactions == 0;
+
+        config.compaction.type = CompactionType::MINIMAL;       //only 5 moves up against 3
+        SimOS minimal (1, 1000, 100, config);
+        fragmentRAM(minimal);
+        auto stats = minimal.NewProcess(200, 1) ? minimal.GetCompactionStats() : CompactionStats{};
+        result = result && stats.compactions == 1 && stats.itemsMoved == 1 && stats.bytesMoved == 200 && stats.savedAdmissions == 1 &&
+                 itemsOf(minimal.GetMemory()) == Items{{0, 100, 1}, {200, 300, 3}, {500, 200, 5}, {700, 200, 8}, {900, 100, 7}};
+
+        config.compaction.type = CompactionType::FULL;
+        SimOS full (1, 1000, 100, config);
+        fragmentRAM(full);
+        stats = full.NewProcess(200, 1) ? full.GetCompactionStats() : CompactionStats{};
+        result = result && stats.itemsMoved == 3 && stats.bytesMoved == 600 && stats.savedAdmissions == 1 &&
+                 itemsOf(full.GetMemory()) == Items{{0, 100, 1}, {100, 300, 3}, {400, 200, 5}, {600, 100, 7}, {700, 200, 8}};
+
+        //250 bytes a pass: the first one only moves 3, the next one 5
+        config.compaction.type = CompactionType::INCREMENTAL;
+        config.compaction.budget = 250;
+        SimOS incremental (1, 1000, 100, config);
+        fragmentRAM(incremental);
+        result = result && !incremental.NewProcess(200, 1) && incremental.NewProcess(200, 1);
+        stats = incremental.GetCompactionStats();
+        result = result && stats.compactions == 2 && stats.itemsMoved == 2 && stats.bytesMoved == 500 && stats.savedAdmissions == 1 &&
+                 itemsOf(incremental.GetMemory()) == Items{{0, 100, 1}, {100, 300, 3}, {400, 200, 5}, {600, 200, 8}, {900, 100, 7}};
+
+        //the running process moved with its item: its exit frees it
+        incremental.SimExit();
+        result = result && itemsOf(incremental.GetMemory()) == Items{{0, 100, 1}, {400, 200, 5}, {600, 200, 8}, {900, 100, 7}};
+
+        //buddy blocks stay put
+        config.placement = PlacementType::BUDDY;
+        config.compaction.type = CompactionType::FULL;
+        SimOS buddy (1, 1024, 128, config);
+        result = result && buddy.NewProcess(512, 1) && !buddy.NewProcess(512, 1) && buddy.GetCompactionStats().compactions == 0;
+
+        if (result) {
+            assert(result);
+            std::cout << "COMPACTION TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "COMPACTION TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (sharedRegion) {
+        //a region shared by a copy on write fork moves for every sharer
+        using Items = decltype(itemsOf(MemoryUse{}));
+        SimOSConfig config;
+        config.placement = PlacementType::FIRST_FIT;
+        config.memory.copyOnWrite = true;
+        config.compaction.type = CompactionType::FULL;
+        SimOS test (1, 1000, 100, config);                      //1
+        test.NewProcess(100, 9);                                //2 [100, 200)
+        test.NewProcess(300, 5);                                //3 [200, 500)
+        test.SimExit();                                         //2, 3 runs
+        bool result = test.SimFork() && test.NewProcess(550, 1);   //4 shares 3's region, 3 slides down for 5
+        result = result && itemsOf(test.GetMemory()) == Items{{0, 100, 1}, {100, 300, 3}, {400, 550, 5}} &&
+                 sameUsage(test.GetMemoryUsage(4), 300, 0) && test.GetCompactionStats().bytesMoved == 300;
+
+        test.DiskReadRequest(0, "a");                           //3 waits -> 4
+        test.SimExit();                                         //4 zombie, 3 owns the region alone
+        result = result && sameUsage(test.GetMemoryUsage(3), 0, 300) && test.GetMemoryStats().sharedBytes == 0;
+        test.DiskJobCompleted(0);
+        test.SimExit();                                         //3 frees [100, 400)
+        result = result && itemsOf(test.GetMemory()) == Items{{0, 100, 1}, {400, 550, 5}} &&
+                 test.NewProcess(350, 1) && sameUsage(test.GetMemoryUsage(5), 0, 550) &&     //6, 5 slides down
+                 itemsOf(test.GetMemory()) == Items{{0, 100, 1}, {100, 550, 5}, {650, 350, 6}};
+
+        if (result) {
+            assert(result);
+            std::cout << "COMPACTION TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "COMPACTION TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (traceRoundTrip) {
+        //every mode saves admissions on a fragmenting workload and replays exactly, items never overlap
+        const char* path = "simos_compaction_test.bin";
+        bool result = true;
+        for (auto type : {CompactionType::FULL, CompactionType::INCREMENTAL, CompactionType::MINIMAL}) {
+            WorkloadConfig workload = fragmentationWorkload(21, 20000);
+            workload.sim.placement = PlacementType::FIRST_FIT;
+            workload.sim.compaction.type = type;
+            workload.sim.compaction.budget = workload.amountOfRAM / 8;
+            CompactionStats recorded;
+            {
+                TraceRecorder recorder (path, workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+                WorkloadGenerator generator (workload);
+                generator.run(recorder);
+                recorded = recorder.sim().GetCompactionStats();
+            }
+            TraceReplayer replayer (path);
+            SimOS replayed (workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+            auto stats = replayer.replay(replayed, true);
+            std::remove(path);
+            unsigned long long end = 0;
+            for (const auto& item : replayed.ViewMemory()) {
+                result = result && item.itemAddress >= end;
+                end = item.itemAddress + item.itemSize;
+            }
+            result = result && replayer.header().compaction == static_cast<std::uint32_t>(type) && stats.complete && stats.mismatches == 0 &&
+                     recorded.savedAdmissions > 0 && recorded.bytesMoved > 0 && end <= workload.amountOfRAM &&
+                     replayed.GetCompactionStats().savedAdmissions == recorded.savedAdmissions;
+        }
+
+        if (result) {
+            assert(result);
+            std::cout << "COMPACTION TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "COMPACTION TEST 3: FAIL" << std::endl;
+        }
+    }
+}
+
+void swapTests() {
+    bool lowestPriority = true;
+    bool victimPolicies = true;
+    bool traceRoundTrip = true;
+    bool plannedVictims = true;
+
+    if (lowestPriority) {
+        //a high priority process pushes the lowest priority idle one out to disk 0, it comes back after an exit
+        using Items = decltype(itemsOf(MemoryUse{}));
+        SimOSConfig config;
+        config.swap.disk = 0;
+        SimOS test (1, 1000, 100, config);                      //1
+        test.NewProcess(400, 5);                                //2 [100, 500) runs
+        test.NewProcess(300, 1);                                //3 [500, 800)
+        test.NewProcess(200, 2);                                //4 [800, 1000)
+        bool result = test.NewProcess(300, 9) && test.GetCPU() == 5 &&     //3 swapped out for 5
+                      itemsOf(test.GetMemory()) == Items{{0, 100, 1}, {100, 400, 2}, {500, 300, 5}, {800, 200, 4}} &&
+                      test.GetDisk(0).PID == 3 && test.GetDisk(0).fileName == "swap" &&
+                      test.GetReadyQueue() == std::vector<int>{2, 4, 1};
+        result = result && !test.NewProcess(200, 1);            //nobody below priority 1
+        auto stats = test.GetSwapStats();
+        result = result && stats.swapOuts == 1 && stats.bytesOut == 300 && stats.swapped == 1 && stats.savedAdmissions == 1;
+
+        test.DiskJobCompleted(0);                               //3 written out, no room yet
+        result = result && test.GetDisk(0).PID == 0 && test.GetSwapStats().swapped == 1 && test.GetMemoryUsage(3).privateBytes == 0;
+        test.SimExit();                                         //5 -> 3 is read back into [500, 800), 2 runs
+        result = result && test.GetDisk(0).PID == 3 && test.GetCPU() == 2 && test.GetReadyQueue() == std::vector<int>{4, 1} &&
+                 itemsOf(test.GetMemory()) == Items{{0, 100, 1}, {100, 400, 2}, {500, 300, 3}, {800, 200, 4}};
+        test.DiskJobCompleted(0);                               //3 ready again
+        stats = test.GetSwapStats();
+        result = result && test.GetReadyQueue() == std::vector<int>{4, 3, 1} && stats.swapIns == 1 && stats.bytesIn == 300 &&
+                 stats.swapped == 0 && test.GetMemoryUsage(3).privateBytes == 300;
+
+        if (result) {
+            assert(result);
+            std::cout << "SWAP TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "SWAP TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (victimPolicies) {
+        //largest first, then least recently run (PID order would pick 2)
+        SimOSConfig config;
+        config.swap.disk = 0;
+        config.swap.victim = SwapVictimType::LARGEST;
+        SimOS largest (1, 1000, 100, config);                   //1
+        largest.NewProcess(100, 5);                             //2 [100, 200) runs
+        largest.NewProcess(200, 1);                             //3 [200, 400)
+        largest.NewProcess(300, 1);                             //4 [400, 700)
+        largest.NewProcess(300, 1);                             //5 [700, 1000)
+        bool result = largest.NewProcess(250, 1) && largest.GetDisk(0).PID == 4 && largest.GetSwapStats().swapOuts == 1 &&
+                      largest.GetMemoryUsage(6).privateBytes == 250;
+
+        config.swap.victim = SwapVictimType::LEAST_RECENTLY_RUN;
+        SimOS recent (1, 1000, 100, config);                    //1
+        recent.NewProcess(200, 5);                              //2 [100, 300) runs
+        recent.NewProcess(200, 5);                              //3 [300, 500)
+        recent.DiskReadRequest(0, "a");                         //3 runs
+        recent.DiskJobCompleted(0);
+        recent.DiskReadRequest(0, "b");                         //2 runs again
+        recent.DiskJobCompleted(0);
+        result = result && recent.NewProcess(300, 9) && recent.GetCPU() == 4;     //4 [500, 800), 3 ran longest ago
+        result = result && recent.NewProcess(300, 0);           //3 then 2 go, 5 [100, 400)
+        result = result && recent.GetDisk(0).PID == 3 && recent.GetDiskQueue(0).front().PID == 2 &&
+                 recent.GetSwapStats().swapOuts == 2 && recent.GetMemoryUsage(5).privateBytes == 300;
+
+        //killing a swapped process drops it from the swap disk and the swapped list
+        SimOS family (1, 1000, 100, config);                    //1
+        family.NewProcess(400, 5);                              //2 [100, 500) runs
+        family.SimFork();                                       //3 [500, 900)
+        result = result && family.NewProcess(400, 9) && family.GetDisk(0).PID == 3;  //4 preempts 2, 3 swapped
+        family.SimExit();                                       //4 exits, 2 runs
+        family.SimExit();                                       //2 exits with 3
+        result = result && family.GetDisk(0).PID == 0 && family.GetSwapStats().swapped == 0 && family.GetMemory().size() == 1;
+
+        if (result) {
+            assert(result);
+            std::cout << "SWAP TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "SWAP TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (traceRoundTrip) {
+        //every victim policy saves admissions on a fragmenting workload and replays exactly
+        const char* path = "simos_swap_test.bin";
+        bool result = true;
+        for (auto victim : {SwapVictimType::LOWEST_PRIORITY, SwapVictimType::LARGEST, SwapVictimType::LEAST_RECENTLY_RUN}) {
+            WorkloadConfig workload = fragmentationWorkload(31, 20000);
+            workload.sim.swap.disk = 1;
+            workload.sim.swap.victim = victim;
+            SwapStats recorded;
+            {
+                TraceRecorder recorder (path, workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+                WorkloadGenerator generator (workload);
+                generator.run(recorder);
+                recorded = recorder.sim().GetSwapStats();
+            }
+            TraceReplayer replayer (path);
+            SimOS replayed (workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+            auto stats = replayer.replay(replayed, true);
+            std::remove(path);
+            auto replayedStats = replayed.GetSwapStats();
+            result = result && replayer.header().swapDevice == 1 && stats.complete && stats.mismatches == 0 &&
+                     recorded.savedAdmissions > 0 && recorded.swapIns > 0 && recorded.swapIns <= recorded.swapOuts &&
+                     replayedStats.swapOuts == recorded.swapOuts && replayedStats.swapped == recorded.swapped;
+        }
+
+        if (result) {
+            assert(result);
+            std::cout << "SWAP TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "SWAP TEST 3: FAIL" << std::endl;
+        }
+    }
+
+    if (plannedVictims) {
+        //3 is the only victim below priority 3 and its 30 bytes can't make room for 60 -> nothing is swapped
+        using Items = decltype(itemsOf(MemoryUse{}));
+        SimOSConfig config;
+        config.placement = PlacementType::FIRST_FIT;
+        config.swap.disk = 0;
+        SimOS test (1, 100, 10, config);                        //1
+        test.NewProcess(30, 5);                                 //2 [10, 40) runs
+        test.NewProcess(30, 1);                                 //3 [40, 70)
+        test.NewProcess(30, 5);                                 //4 [70, 100)
+        bool result = !test.NewProcess(60, 3) && test.GetSwapStats().swapOuts == 0 && test.GetDisk(0).PID == 0 &&
+                      itemsOf(test.GetMemory()) == Items{{0, 10, 1}, {10, 30, 2}, {40, 30, 3}, {70, 30, 4}};
+        result = result && test.NewProcess(30, 3) && test.GetDisk(0).PID == 3 && test.GetSwapStats().swapOuts == 1;
+
+        //3 is planned first but [700, 1000) only needs 5 and 6
+        SimOS adjacent (1, 1000, 100, config);                  //1
+        adjacent.NewProcess(200, 8);                            //2 [100, 300) runs
+        adjacent.NewProcess(100, 1);                            //3 [300, 400)
+        adjacent.NewProcess(300, 6);                            //4 [400, 700)
+        adjacent.NewProcess(100, 2);                            //5 [700, 800)
+        adjacent.NewProcess(200, 3);                            //6 [800, 1000)
+        result = result && adjacent.NewProcess(300, 5) && adjacent.GetDisk(0).PID == 5 && adjacent.GetDiskQueue(0).front().PID == 6 &&
+                 adjacent.GetSwapStats().swapOuts == 2 && adjacent.GetMemoryUsage(3).privateBytes == 100 &&
+                 adjacent.GetMemoryUsage(7).privateBytes == 300;
+
+        //buddy: 3 and 4 join into [32, 128) but the aligned 64 byte block is 4's alone
+        config.placement = PlacementType::BUDDY;
+        SimOS buddy (1, 128, 16, config);                       //1
+        buddy.NewProcess(16, 9);                                //2 [16, 32) runs
+        buddy.NewProcess(32, 1);                                //3 [32, 64)
+        buddy.NewProcess(64, 2);                                //4 [64, 128)
+        result = result && buddy.NewProcess(64, 5) && buddy.GetDisk(0).PID == 4 && buddy.GetSwapStats().swapOuts == 1 &&
+                 buddy.GetMemoryUsage(3).privateBytes == 32;
+
+        if (result) {
+            assert(result);
+            std::cout << "SWAP TEST 4: PASS" << std::endl;
+        } else {
+            std::cout << "SWAP TEST 4: FAIL" << std::endl;
+        }
+    }
+}
+
+bool near(double a, double b) {
+    return a - b < 1e-9 && b - a < 1e-9;
+}
+
+//only the listed buckets are non-empty
+bool sameBuckets(const FragmentationStats& stats, const std::vector<std::pair<int, unsigned long long>>& buckets) {
+    auto expected = decltype(stats.holeSizes){};
+    for (auto& bucket : buckets) {
+        expected[bucket.first] = bucket.second;
+    }
+    return stats.holeSizes == expected;
+}
+
+void fragmentationTests() {
+    bool layouts = true;
+    bool matchesScan = true;
+
+    if (layouts) {
+        SimOSConfig config;
+        config.placement = PlacementType::FIRST_FIT;
+        SimOS test (1, 1000, 100, config);
+        fragmentRAM(test);                                      //holes of 100, 50, 150
+        auto stats = test.GetFragmentationStats();
+        bool result = stats.holes == 3 && stats.largestHole == 150 && stats.freeBytes == 300 && near(stats.externalFragmentation, 0.5) &&
+                      sameBuckets(stats, {{5, 1}, {6, 1}, {7, 1}}) && stats.fragmentationFailures == 0 && stats.capacityFailures == 0;
+        result = result && !test.NewProcess(200, 1) && !test.NewProcess(400, 1);
+        test.SimExit();                                         //3 -> [100, 550)
+        stats = test.GetFragmentationStats();
+        result = result && stats.holes == 2 && stats.largestHole == 450 && stats.freeBytes == 600 && near(stats.externalFragmentation, 0.25) &&
+                 sameBuckets(stats, {{7, 1}, {8, 1}}) && stats.fragmentationFailures == 1 && stats.capacityFailures == 1;
+
+        //buddy: free blocks are the holes
+        config.placement = PlacementType::BUDDY;
+        SimOS buddy (1, 1024, 128, config);
+        stats = buddy.GetFragmentationStats();
+        result = result && stats.holes == 3 && stats.largestHole == 512 && stats.freeBytes == 896 && sameBuckets(stats, {{7, 1}, {8, 1}, {9, 1}});
+        //33 bytes take a 64 byte block, 48 are left -> 60 bytes fail for lack of space, not fragmentation
+        SimOS rounded (1, 128, 16, config);
+        result = result && rounded.NewProcess(33, 1) && !rounded.NewProcess(60, 1);
+        stats = rounded.GetFragmentationStats();
+        result = result && stats.freeBytes == 48 && stats.capacityFailures == 1 && stats.fragmentationFailures == 0;
+
+        //an admission swapping saves isn't a failure
+        SimOSConfig swapping;
+        swapping.swap.disk = 0;
+        SimOS swapped (1, 1000, 100, swapping);
+        result = result && swapped.NewProcess(100, 5) && swapped.NewProcess(800, 1) &&     //2 runs, 3 idle
+                 swapped.NewProcess(300, 9) && swapped.GetSwapStats().savedAdmissions == 1;
+        stats = swapped.GetFragmentationStats();
+        result = result && stats.capacityFailures == 0 && stats.fragmentationFailures == 0;
+
+        //paged: one hole per free frame, never fragmented
+        config.memory.paged = true;
+        config.memory.pageSize = 100;
+        SimOS paged (1, 600, 100, config);
+        result = result && paged.NewProcess(200, 1) && !paged.NewProcess(400, 1);
+        stats = paged.GetFragmentationStats();
+        result = result && stats.holes == 3 && stats.largestHole == 100 && stats.freeBytes == 300 && stats.externalFragmentation == 0.0 &&
+                 sameBuckets(stats, {{6, 3}}) && stats.capacityFailures == 1 && stats.fragmentationFailures == 0;
+
+        if (result) {
+            assert(result);
+            std::cout << "FRAGMENTATION TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "FRAGMENTATION TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (matchesScan) {
+        //after heavy churn the live counters agree with a scan of the gaps between items
+        bool result = true;
+        for (auto placement : {PlacementType::WORST_FIT, PlacementType::BEST_FIT, PlacementType::FIRST_FIT, PlacementType::NEXT_FIT}) {
+            for (auto compaction : {CompactionType::NONE, CompactionType::MINIMAL}) {
+                WorkloadConfig workload = fragmentationWorkload(5, 20000);
+                workload.sim.placement = placement;
+                workload.sim.compaction.type = compaction;
+                SimOS test (workload.numberOfDisks, workload.amountOfRAM, workload.sizeOfOS, workload.sim);
+                WorkloadGenerator generator (workload);
+                auto run = generator.run(test);
+
+                FragmentationStats scan;
+                unsigned long long end = 0;
+                auto hole = [&scan](unsigned long long size) {
+                    if (size > 0) {
+                        ++scan.holes;
+                        scan.freeBytes += size;
+                        scan.largestHole = std::max(scan.largestHole, size);
+                        ++scan.holeSizes[HoleHistogram::bucketOf(size)];
+                    }
+                };
+                for (const auto& item : test.ViewMemory()) {
+                    hole(item.itemAddress - end);
+                    end = item.itemAddress + item.itemSize;
+                }
+                hole(workload.amountOfRAM - end);
+                auto stats = test.GetFragmentationStats();
+                result = result && stats.holes == scan.holes && stats.largestHole == scan.largestHole && stats.freeBytes == scan.freeBytes &&
+                         stats.holeSizes == scan.holeSizes && stats.fragmentationFailures + stats.capacityFailures >= run.rejected &&
+                         stats.fragmentationFailures + stats.capacityFailures <= run.rejected + run.failedForks;
+                result = result && (compaction == CompactionType::NONE ? stats.fragmentationFailures > 0 :
+                                                                         test.GetCompactionStats().savedAdmissions > 0);
+            }
+        }
+
+        if (result) {
+            assert(result);
+            std::cout << "FRAGMENTATION TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "FRAGMENTATION TEST 2: FAIL" << std::endl;
+        }
+    }
+}
+
+void engineTests() {
+    bool timelineCheck = true;
+    bool loadCheck = true;
+    bool multiCore = true;
+    bool mergedReads = true;
+    bool swapTraffic = true;
+
+    if (timelineCheck) {
+        //A: runs 0-1, preempted by B, runs 5-7, disk 7-12, runs 12-14
+        //B: runs 1-5
+        EventEngine test (1, OS_RAM, OS_SIZE, {DiskModel{ServiceModel::FIXED, 5, 5}});
+        test.submit(Job{0, 1000, 1, {3, 2}, {0}});          //A -> 2
+        test.submit(Job{1, 1000, 2, {4}, {}});              //B -> 3
+        test.submit(Job{2, OS_RAM, 5, {1}, {}});            //never fits
+        auto report = test.run();
+
+        bool result = (
+            (report.completed == 2) && (report.rejected == 1) && (report.stranded == 0) &&
+            near(report.makespan, 14) &&
+            near(report.throughput, 2.0 / 14) &&
+            near(report.avgTurnaround, 9) && near(report.maxTurnaround, 14) &&
+            near(report.avgWaiting, 2) &&                   //A waited 4, B 0
+            near(report.cpuUtilisation, 9.0 / 14) &&
+            near(report.diskUtilisation[0], 5.0 / 14) &&
+            (test.sim().ViewMemory().size() == 1)           //only the OS left
+        );
+        if (result) {
+            assert(result);
+            std::cout << "ENGINE TEST 1: PASS" << std::endl;
+        } else {
+            std::cout << "ENGINE TEST 1: FAIL" << std::endl;
+        }
+    }
+
+    if (loadCheck) {
+        //more demand than RAM -> jobs queue for admission, everything still finishes
+        const int JOBS = 2000;
+        EventEngine test (2, 10'000, 1'000, {DiskModel{ServiceModel::EXPONENTIAL, 2, 0}, DiskModel{ServiceModel::UNIFORM, 1, 3}}, 99);
+        Random random (5);
+        for (int i = 0; i < JOBS; ++i) {
+            int disk = static_cast<int>(random.uniform(0, 1));
+            test.submit(Job{i * 0.5, random.uniform(100, 3000), static_cast<int>(random.uniform(1, 5)), 
+                           {random.exponential(1), random.exponential(1)}, {disk}});
+        }
+        auto report = test.run();
+
+        bool result = (
+            (report.completed == JOBS) && (report.stranded == 0) &&
+            (report.cpuUtilisation > 0) && (report.cpuUtilisation <= 1) &&
+            (report.diskUtilisation[0] > 0) && (report.diskUtilisation[0] <= 1) &&
+            (report.diskUtilisation[1] > 0) && (report.diskUtilisation[1] <= 1) &&
+            (report.avgWaiting > 0) && (report.avgTurnaround > report.avgWaiting) &&
+            (test.sim().ViewMemory().size() == 1)
+        );
+        if (result) {
+            assert(result);
+            std::cout << "ENGINE TEST 2: PASS" << std::endl;
+        } else {
+            std::cout << "ENGINE TEST 2: FAIL" << std::endl;
+        }
+    }
+
+    if (multiCore) {
+        //two cores -> 2 and 3 run 0-2 side by side, 4 and 5 run 2-4
+        SimOSConfig config;
+        config.cores = 2;
+        EventEngine test (1, OS_RAM, OS_SIZE, {}, 1, config);
+        for (int i = 0; i < 4; ++i) {
+            test.submit(Job{0, 1000, 1, {2}, {}});
+        }
+        auto report = test.run();
+
+        bool result = (
+            (report.completed == 4) && (report.stranded == 0) &&
+            near(report.makespan, 4) && near(report.avgTurnaround, 3) &&
+            near(report.cpuUtilisation, 1) &&
+            (test.sim().ViewMemory().size() == 1)
+        );
+        if (result) {
+            assert(result);
+            std::cout << "ENGINE TEST 3: PASS" << std::endl;
+        } else {
+            std::cout << "ENGINE TEST 3: FAIL" << std::endl;
+        }
+    }
+
+    if (mergedReads) {
+        //merged reads all move on to their next burst: 2 reads 1-6, 3 4 5 ride one job 6-11,
+        //2 reads again 11-16, 3 4 5 ride another 16-21 and finish at 22, 23, 24
+        SimOSConfig config;
+        config.disks.merge = true;
+        EventEngine test (1, OS_RAM, OS_SIZE, {DiskModel{ServiceModel::FIXED, 5, 5}}, 1, config);
+        for (int i = 0; i < 4; ++i) {
+            test.submit(Job{0, 1000, 1, {1, 1, 1}, {0, 0}});
+        }
+        auto report = test.run();
+        auto stats = test.sim().GetDiskStats(0);
+
+        bool result = (
+            (report.completed == 4) && (report.stranded == 0) &&
+            (stats.merged == 4) && (stats.dispatched == 4) &&
+            near(report.makespan, 24) && near(report.diskUtilisation[0], 20.0 / 24) &&
+            (test.sim().ViewMemory().size() == 1)
+        );
+        if (result) {
+            assert(result);
+            std::cout << "ENGINE TEST 4: PASS" << std::endl;
+        } else {
+            std::cout << "ENGINE TEST 4: FAIL" << std::endl;
+        }
+    }
+
+    if (swapTraffic) {
+        //the late high priority jobs swap low priority ones out on disk 1, those writes and reads move no job on
+        SimOSConfig config;
+        config.swap.disk = 1;
+        EventEngine test (2, 130, 10, {DiskModel{ServiceModel::FIXED, 2, 2}, DiskModel{ServiceModel::FIXED, 3, 3}}, 1, config);
+        for (int i = 0; i < 4; ++i) {
+            test.submit(Job{0, 30, 1, {4}, {}});
+        }
+        for (int i = 0; i < 2; ++i) {
+            test.submit(Job{1, 30, 5, {2, 2}, {0}});
+        }
+        auto report = test.run();
+        auto stats = test.sim().GetSwapStats();
+
+        bool result = (
+            (report.completed == 6) && (report.stranded == 0) &&
+            (stats.swapOuts == 2) && (stats.swapIns == 2) &&
+            (report.diskUtilisation[1] > 0) &&
+            (test.sim().ViewMemory().size() == 1)
+        );
+        if (result) {
+            assert(result);
+            std::cout << "ENGINE TEST 5: PASS" << std::endl;
+        } else {
+            std::cout << "ENGINE TEST 5: FAIL" << std::endl;
+        }
+    }
+}
+
+int main() {
+    //same priority process does NOT kick out current process in CPU
+    OStests();      //1 test
+    std::cout << "-----------------------" << std::endl;
+    emptyTests();   //3 test
+    std::cout << "-----------------------" << std::endl;    
+    RAMTests();     //6 tests
+    std::cout << "-----------------------" << std::endl;
+    diskTests();    //3 tests
+    std::cout << "-----------------------" << std::endl;
+    exitTests();    //5 tests
+    std::cout << "-----------------------" << std::endl;
+    waitTests();    //5 tests 
+    std::cout << "-----------------------" << std::endl;
+    placementTests();   //2 tests
+    std::cout << "-----------------------" << std::endl;
+    viewTests();    //1 test
+    std::cout << "-----------------------" << std::endl;
+    batchTests();   //2 tests
+    std::cout << "-----------------------" << std::endl;
+    traceTests();   //1 test
+    std::cout << "-----------------------" << std::endl;
+    workloadTests();    //2 tests
+    std::cout << "-----------------------" << std::endl;
+    engineTests();  //5 tests
+    std::cout << "-----------------------" << std::endl;
+    schedulerTests();   //3 tests
+    std::cout << "-----------------------" << std::endl;
+    readyQueueTests();  //1 test
+    std::cout << "-----------------------" << std::endl;
+    smpTests();     //5 tests
+    std::cout << "-----------------------" << std::endl;
+    concurrentTests();  //3 tests
+    std::cout << "-----------------------" << std::endl;
+    sweepTests();   //1 test
+    std::cout << "-----------------------" << std::endl;
+    diskPolicyTests();  //3 tests
+    std::cout << "-----------------------" << std::endl;
+    diskMergeTests();   //3 tests
+    std::cout << "-----------------------" << std::endl;
+    pagingTests();  //4 tests
+    std::cout << "-----------------------" << std::endl;
+    copyOnWriteTests(); //3 tests
+    std::cout << "-----------------------" << std::endl;
+    compactionTests();  //3 tests
+    std::cout << "-----------------------" << std::endl;
+    fragmentationTests();   //2 tests
+    std::cout << "-----------------------" << std::endl;
+    swapTests();    //4 tests
     
 }
\ No newline at end of file
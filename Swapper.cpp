@@ -0,0 +1,101 @@
+//Jacky Qiu
+//----------------------------------
+#include "Swapper.h"
+
+Swapper::Swapper() :
+    candidates_{PoolAllocator<Key>(&pool_)},
+    parked_{PoolAllocator<std::pair<unsigned long long, Process*>>(&pool_)},
+    candidateBytes_{0},
+    stamps_{0} {}
+
+void Swapper::configure(const SwapSettings& settings) {
+    settings_ = settings;
+}
+
+bool Swapper::enabled() const {
+    return settings_.disk >= 0;
+}
+
+int Swapper::disk() const {
+    return settings_.disk;
+}
+
+Swapper::Key Swapper::keyOf(const Process* ptr) const {
+    long long order = 0;
+    switch (settings_.victim) {
+        case SwapVictimType::LOWEST_PRIORITY:
+            order = ptr->priority_;
+            break;
+        case SwapVictimType::LARGEST:
+            order = -static_cast<long long>(ptr->size_);
+            break;
+        case SwapVictimType::LEAST_RECENTLY_RUN:
+            break;
+    }
+    return Key{order, ptr->lastRun_, ptr->PID_, const_cast<Process*>(ptr)};
+}
+
+void Swapper::track(Process* ptr) {
+    if (candidates_.insert(keyOf(ptr)).second) {
+        candidateBytes_ += ptr->size_;
+    }
+}
+
+void Swapper::untrack(Process* ptr) {
+    if (candidates_.erase(keyOf(ptr)) > 0) {
+        candidateBytes_ -= ptr->size_;
+    }
+}
+
+unsigned long long Swapper::candidateBytes() const {
+    return candidateBytes_;
+}
+
+void Swapper::swapOut(Process* ptr) {
+    untrack(ptr);
+    ptr->swap_ = SwapState::SWAPPING_OUT;
+    ++stats_.swapOuts;
+    stats_.bytesOut += ptr->size_;
+    ++stats_.swapped;
+}
+
+void Swapper::park(Process* ptr) {
+    ptr->swap_ = SwapState::SWAPPED;
+    ptr->swapStamp_ = ++stamps_;
+    parked_.emplace(ptr->swapStamp_, ptr);
+}
+
+Process* Swapper::next() const {
+    return parked_.empty() ? nullptr : parked_.begin()->second;
+}
+
+void Swapper::swapIn(Process* ptr) {
+    parked_.erase({ptr->swapStamp_, ptr});
+    ptr->swap_ = SwapState::SWAPPING_IN;
+    ++stats_.swapIns;
+    stats_.bytesIn += ptr->size_;
+}
+
+void Swapper::resident(Process* ptr) {
+    ptr->swap_ = SwapState::RESIDENT;
+    --stats_.swapped;
+}
+
+void Swapper::forget(Process* ptr) {
+    untrack(ptr);
+    if (ptr->swap_ == SwapState::SWAPPED) {
+        parked_.erase({ptr->swapStamp_, ptr});
+    }
+    if (ptr->swap_ != SwapState::RESIDENT) {
+        ptr->swap_ = SwapState::RESIDENT;
+        --stats_.swapped;
+    }
+}
+
+void Swapper::savedAdmission() {
+    ++stats_.savedAdmissions;
+}
+
+const SwapStats& Swapper::stats() const {
+    return stats_;
+}
@@ -0,0 +1,96 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <set>
+#include "NodePool.h"
+#include "Process.h"
+
+//Which idle process the medium-term scheduler swaps out to admit a new one
+enum class SwapVictimType {
+    LOWEST_PRIORITY,        //default, only processes below the new one's priority
+    LARGEST,                //frees the most per swap, any priority
+    LEAST_RECENTLY_RUN      //dispatched longest ago, any priority
+};
+
+struct SwapSettings {
+    int disk{-1};                           //disk the swap traffic queues on, -1 = no swapping
+    SwapVictimType victim{SwapVictimType::LOWEST_PRIORITY};
+};
+
+struct SwapStats {
+    unsigned long long swapOuts{0};
+    unsigned long long swapIns{0};
+    unsigned long long bytesOut{0};
+    unsigned long long bytesIn{0};
+    unsigned long long savedAdmissions{0};  //processes admitted only thanks to swapping
+    size_t swapped{0};                      //without RAM right now, writes / reads in flight included
+};
+
+//Medium-term scheduler for SimOS (SimOSConfig::swap, contiguous memory only)
+//Candidates are resident, unshared user processes sitting in a ready queue, kept in a tree ordered by
+//the victim policy -> picking a victim and following processes in and out of the ready queues is O(log n)
+//Swapped out processes wait in swap out order, the oldest comes back first once its size fits
+//SimOS does the memory and disk work, this only keeps the order and Process::swap_
+class Swapper {
+    public:
+        Swapper();
+        Swapper(const Swapper&) = delete;
+        Swapper& operator=(const Swapper&) = delete;
+
+        void configure(const SwapSettings& settings);
+        bool enabled() const;
+        int disk() const;
+
+        //ready queue membership
+        void track(Process* ptr);
+        void untrack(Process* ptr);
+        unsigned long long candidateBytes() const;
+        //candidates a process of the given priority may take memory from, best first, until visit returns true
+        template <typename Visit>
+        void forEachVictim(int priority, Visit visit) const {
+            for (const auto& key : candidates_) {
+                if (settings_.victim == SwapVictimType::LOWEST_PRIORITY && key.ptr->priority_ >= priority) {
+                    return;
+                }
+                if (visit(key.ptr)) {
+                    return;
+                }
+            }
+        }
+
+        void swapOut(Process* ptr);             //memory released, write queued
+        void park(Process* ptr);                //write done, waits for memory
+        Process* next() const;                  //oldest parked process, nullptr if none
+        void swapIn(Process* ptr);              //memory reserved for next(), read queued
+        void resident(Process* ptr);            //read done
+        void forget(Process* ptr);              //process is gone
+        void savedAdmission();
+        const SwapStats& stats() const;
+
+    private:
+        struct Key {
+            long long order;                    //by victim policy, lowest goes first
+            unsigned long long lastRun;
+            int PID;
+            Process* ptr;
+            bool operator<(const Key& other) const {
+                if (order != other.order) {
+                    return order < other.order;
+                }
+                return lastRun != other.lastRun ? lastRun < other.lastRun : PID < other.PID;
+            }
+        };
+        using Candidates = std::set<Key, std::less<Key>, PoolAllocator<Key>>;
+        using Parked = std::set<std::pair<unsigned long long, Process*>, std::less<std::pair<unsigned long long, Process*>>,
+                                PoolAllocator<std::pair<unsigned long long, Process*>>>;
+
+        SwapSettings settings_;
+        NodePool pool_;
+        Candidates candidates_;
+        Parked parked_;                         //(swapStamp_, process)
+        unsigned long long candidateBytes_;
+        unsigned long long stamps_;
+        SwapStats stats_;
+
+        Key keyOf(const Process* ptr) const;
+};
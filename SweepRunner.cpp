@@ -0,0 +1,222 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include "SweepRunner.h"
+
+SweepRunner::SweepRunner(const TraceReplayer& trace, std::vector<SweepConfig> configs) :
+    trace_{trace},
+    configs_{std::move(configs)},
+    results_{configs_.size()} {}
+
+std::uint64_t SweepRunner::pack(std::uint32_t begin, std::uint32_t end) {
+    return (static_cast<std::uint64_t>(end) << 32) | begin;
+}
+
+const std::vector<SweepResult>& SweepRunner::run(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, configs_.size())));
+
+    //contiguous shares up front, stealing only evens out the tail
+    work_ = std::vector<WorkRange>(threads);
+    auto count = static_cast<std::uint32_t>(configs_.size());
+    for (unsigned i = 0; i < threads; ++i) {
+        work_[i].range.store(pack(count * i / threads, count * (i + 1) / threads));
+    }
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) {
+        pool.emplace_back(&SweepRunner::worker, this, i);
+    }
+    worker(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    return results_;
+}
+
+void SweepRunner::worker(unsigned self) {
+    std::uint32_t index = 0;
+    while (take(self, index) || (steal(self) && take(self, index))) {
+        runOne(index);
+    }
+}
+
+bool SweepRunner::take(unsigned self, std::uint32_t& index) {
+    auto& slot = work_[self].range;
+    auto range = slot.load();
+    while (true) {
+        auto begin = static_cast<std::uint32_t>(range);
+        auto end = static_cast<std::uint32_t>(range >> 32);
+        if (begin >= end) {
+            return false;
+        }
+        if (slot.compare_exchange_weak(range, pack(begin + 1, end))) {
+            index = begin;
+            return true;
+        }
+    }
+}
+
+bool SweepRunner::steal(unsigned self) {
+    //one lap over the other workers, take the back half of the first non-empty range
+    auto workers = static_cast<unsigned>(work_.size());
+    for (unsigned step = 1; step < workers; ++step) {
+        auto& victim = work_[(self + step) % workers].range;
+        auto range = victim.load();
+        while (true) {
+            auto begin = static_cast<std::uint32_t>(range);
+            auto end = static_cast<std::uint32_t>(range >> 32);
+            if (begin >= end) {
+                break;
+            }
+            auto half = (end - begin + 1) / 2;
+            if (victim.compare_exchange_weak(range, pack(begin, end - half))) {
+                //own range is empty, so nobody else writes it
+                work_[self].range.store(pack(end - half, end));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void SweepRunner::runOne(std::uint32_t index) {
+    const auto& config = configs_[index];
+    SimOS sim (config.numberOfDisks, config.amountOfRAM, config.sizeOfOS, config.sim);
+    SweepResult result;
+    result.replay = trace_.replay(sim, true);
+
+    unsigned long long lastEnd = 0;
+    for (const auto& item : sim.ViewMemory()) {
+        ++result.resident;
+        result.usedRAM += item.itemSize;
+        result.largestHole = std::max(result.largestHole, item.itemAddress - lastEnd);
+        lastEnd = item.itemAddress + item.itemSize;
+    }
+    if (config.amountOfRAM > lastEnd) {
+        result.largestHole = std::max(result.largestHole, config.amountOfRAM - lastEnd);
+    }
+    for (int core = 0; core < sim.GetCoreCount(); ++core) {
+        result.ready += sim.ViewReadyQueue(core).size();
+    }
+    for (int disk = 0; disk < sim.GetDiskCount(); ++disk) {
+        result.diskWaiting += sim.ViewDiskQueue(disk).size() + (sim.GetDisk(disk).PID != 0);
+    }
+    results_[index] = result;
+}
+
+const std::vector<SweepConfig>& SweepRunner::configs() const {
+    return configs_;
+}
+
+const std::vector<SweepResult>& SweepRunner::results() const {
+    return results_;
+}
+
+bool SweepRunner::write(const std::string& path) const {
+    std::vector<char> out (SWEEP_MAGIC, SWEEP_MAGIC + sizeof(SWEEP_MAGIC));
+    putFixed<std::uint32_t>(out, SWEEP_VERSION);
+    putFixed<std::uint64_t>(out, configs_.size());
+
+    using Integer = std::function<unsigned long long(const SweepConfig&, const SweepResult&)>;
+    std::vector<std::pair<const char*, Integer>> integers {
+        {"disks", [](const SweepConfig& c, const SweepResult&) { return static_cast<unsigned long long>(c.numberOfDisks); }},
+        {"ram", [](const SweepConfig& c, const SweepResult&) { return c.amountOfRAM; }},
+        {"os_size", [](const SweepConfig& c, const SweepResult&) { return c.sizeOfOS; }},
+        {"placement", [](const SweepConfig& c, const SweepResult&) { return static_cast<unsigned long long>(c.sim.placement); }},
+        {"scheduler", [](const SweepConfig& c, const SweepResult&) { return static_cast<unsigned long long>(c.sim.scheduler.type); }},
+        {"cores", [](const SweepConfig& c, const SweepResult&) { return static_cast<unsigned long long>(c.sim.cores); }},
+        {"complete", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.replay.complete); }},
+        {"calls", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.replay.calls); }},
+        {"mismatches", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.replay.mismatches); }},
+        {"admitted", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.replay.admitted); }},
+        {"rejected", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.replay.rejected); }},
+        {"forks", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.replay.forks); }},
+        {"failed_forks", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.replay.failedForks); }},
+        {"resident", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.resident); }},
+        {"used_ram", [](const SweepConfig&, const SweepResult& r) { return r.usedRAM; }},
+        {"largest_hole", [](const SweepConfig&, const SweepResult& r) { return r.largestHole; }},
+        {"ready", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.ready); }},
+        {"disk_waiting", [](const SweepConfig&, const SweepResult& r) { return static_cast<unsigned long long>(r.diskWaiting); }}
+    };
+    putFixed<std::uint32_t>(out, static_cast<std::uint32_t>(integers.size() + 1));
+
+    auto name = [&out](const char* text) {
+        std::string value (text);
+        putFixed<std::uint32_t>(out, static_cast<std::uint32_t>(value.size()));
+        out.insert(out.end(), value.begin(), value.end());
+    };
+    for (auto& column : integers) {
+        name(column.first);
+        out.push_back(0);
+        for (size_t row = 0; row < configs_.size(); ++row) {
+            putFixed<unsigned long long>(out, column.second(configs_[row], results_[row]));
+        }
+    }
+    name("seconds");
+    out.push_back(1);
+    for (const auto& result : results_) {
+        putFixed<double>(out, result.replay.seconds);
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+std::vector<SweepColumn> readSweepColumns(const std::string& path) {
+    std::vector<SweepColumn> columns;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return columns;
+    }
+    std::vector<char> data;
+    char chunk[1 << 16];
+    size_t got = 0;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + got);
+    }
+    std::fclose(file);
+
+    size_t at = 0;
+    auto has = [&](size_t bytes) { return data.size() - at >= bytes; };
+    if (!has(24) || !std::equal(SWEEP_MAGIC, SWEEP_MAGIC + sizeof(SWEEP_MAGIC), data.data()) ||
+        getFixed<std::uint32_t>(data.data() + 8) != SWEEP_VERSION) {
+        return columns;
+    }
+    auto rows = getFixed<std::uint64_t>(data.data() + 12);
+    auto count = getFixed<std::uint32_t>(data.data() + 20);
+    at = 24;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        if (!has(4)) {
+            return {};
+        }
+        auto length = getFixed<std::uint32_t>(data.data() + at);
+        at += 4;
+        //a corrupt row count must not wrap the size it asks for
+        if (!has(length + 1ULL) || rows > (data.size() - at - length - 1) / 8) {
+            return {};
+        }
+        SweepColumn column;
+        column.name.assign(data.data() + at, length);
+        at += length;
+        column.real = data[at++] == 1;
+        for (std::uint64_t row = 0; row < rows; ++row, at += 8) {
+            if (column.real) {
+                column.reals.push_back(getFixed<double>(data.data() + at));
+            } else {
+                column.integers.push_back(getFixed<unsigned long long>(data.data() + at));
+            }
+        }
+        columns.push_back(std::move(column));
+    }
+    return columns;
+}
@@ -0,0 +1,75 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SimOS.h"
+#include "TraceReplayer.h"
+
+//One machine to try the trace on
+struct SweepConfig {
+    int numberOfDisks{1};
+    unsigned long long amountOfRAM{0};
+    unsigned long long sizeOfOS{0};
+    SimOSConfig sim{};
+};
+
+//Metrics of one configuration after the whole trace
+struct SweepResult {
+    ReplayStats replay;             //mismatches = calls that behaved differently than in the recording
+    size_t resident{0};             //processes in RAM at the end, OS included
+    unsigned long long usedRAM{0};
+    unsigned long long largestHole{0};
+    size_t ready{0};                //summed over cores
+    size_t diskWaiting{0};          //in service + queued, summed over disks
+};
+
+//Replays one trace against many configurations in parallel
+//Each worker owns its SimOS; the only thing shared is the read-only mapped trace and
+//a padded range of config indexes per worker that idle workers steal half of
+//Results go to one preallocated slot per configuration -> no locks, no shared writes
+class SweepRunner {
+    public:
+        SweepRunner(const TraceReplayer& trace, std::vector<SweepConfig> configs);
+
+        //threads = 0 -> hardware concurrency
+        const std::vector<SweepResult>& run(unsigned threads = 0);
+        const std::vector<SweepConfig>& configs() const;
+        const std::vector<SweepResult>& results() const;
+        //columnar file: every column is one contiguous array (see SweepColumns)
+        bool write(const std::string& path) const;
+
+    private:
+        //[begin, end) packed in one word so taking from the front and stealing the back are single CASes
+        struct alignas(64) WorkRange {
+            std::atomic<std::uint64_t> range{0};
+        };
+        static std::uint64_t pack(std::uint32_t begin, std::uint32_t end);
+
+        const TraceReplayer& trace_;
+        std::vector<SweepConfig> configs_;
+        std::vector<SweepResult> results_;
+        std::vector<WorkRange> work_;
+
+        void worker(unsigned self);
+        bool take(unsigned self, std::uint32_t& index);
+        bool steal(unsigned self);
+        void runOne(std::uint32_t index);
+};
+
+//Columnar results file
+//  "SIMSWEEP" u32 version, u64 rows, u32 columns
+//  per column: u32 name length, name bytes, u8 type (0 = u64, 1 = f64), rows * 8 bytes
+//  every fixed width field is little endian on any host (putFixed), f64 as its IEEE 754 bits
+struct SweepColumn {
+    std::string name;
+    bool real{false};
+    std::vector<unsigned long long> integers;
+    std::vector<double> reals;
+};
+constexpr char SWEEP_MAGIC[8] {'S','I','M','S','W','E','E','P'};
+constexpr std::uint32_t SWEEP_VERSION {1};
+
+std::vector<SweepColumn> readSweepColumns(const std::string& path);
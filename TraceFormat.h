@@ -0,0 +1,141 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//Binary trace of SimOS calls
+//
+//  header : "SIMTRACE" u32 version, i32 disks, u32 placement, u32 cores (0 = 1), u64 RAM, u64 OS size,
+//           u32 scheduler, i32 quantum, i32 levels, i32 boost interval (version 2+),
+//           u32 disk policy (bit 16 = merge), i32 deadline (version 3+),
+//           u32 replacement (bit 16 = paged, bit 17 = copy on write), i32 swap disk, u64 page size, u64 swap pages,
+//           u64 working set window, u64 aging interval (version 4+),
+//           u32 compaction, u32 reserved, u64 compaction budget (version 5+),
+//           i32 swap disk, u32 swap victim policy (version 6+),
+//           u32 per disk policy count, u32 policy of each of those disks (version 7)
+//  records: one TraceOp byte followed by its fields, END closes the trace
+//
+//Integers are LEB128 varints (signed ones zigzag encoded first) so most records are 2-4 bytes
+//File names are interned: DEFINE_FILE gives a name an id, later records use the id
+//Fixed width header fields are little endian
+constexpr char TRACE_MAGIC[8] {'S','I','M','T','R','A','C','E'};
+constexpr std::uint32_t TRACE_VERSION {7};
+constexpr size_t TRACE_HEADER_SIZE {132};           //plus 4 bytes per disk policy
+constexpr size_t TRACE_HEADER_SIZE_V6 {128};        //version 6 traces (one disk policy) still replay
+constexpr size_t TRACE_HEADER_SIZE_V5 {120};        //version 5 traces (no swapping) still replay
+constexpr size_t TRACE_HEADER_SIZE_V4 {104};        //version 4 traces (no compaction) still replay
+constexpr size_t TRACE_HEADER_SIZE_V3 {64};         //version 3 traces (contiguous memory) still replay
+constexpr size_t TRACE_HEADER_SIZE_V2 {56};         //version 2 traces (FIFO disks, no blocks) still replay
+constexpr size_t TRACE_HEADER_SIZE_V1 {40};         //version 1 traces (default scheduler) still replay
+constexpr std::uint32_t TRACE_DISK_MERGE {1u << 16};
+constexpr std::uint32_t TRACE_MEMORY_PAGED {1u << 16};
+constexpr std::uint32_t TRACE_MEMORY_COW {1u << 17};
+
+enum class TraceOp : std::uint8_t {
+    NEW_PROCESS = 1,    //size, priority, result
+    FORK,               //result
+    EXIT,
+    WAIT,
+    DISK_READ,          //disk, fileId, block, size (block & size version 3+)
+    DISK_COMPLETE,      //disk
+    GET_CPU,            //PID
+    GET_READY_QUEUE,    //count, PIDs
+    GET_MEMORY,         //count, (address, size, PID)...
+    GET_DISK,           //disk, PID, fileId
+    GET_DISK_QUEUE,     //disk, count, (PID, fileId)...
+    TIMER_TICK,
+    ACCESS_MEMORY,      //address, result (version 4)
+    WRITE_MEMORY,       //address, result (version 4)
+    DEFINE_FILE = 0x40, //id, length, bytes
+    END = 0xFF
+};
+
+struct TraceHeader {
+    std::uint32_t version {TRACE_VERSION};
+    std::int32_t numberOfDisks {0};
+    std::uint32_t placement {0};
+    std::uint32_t cores {1};
+    unsigned long long amountOfRAM {0};
+    unsigned long long sizeOfOS {0};
+    std::uint32_t scheduler {0};
+    std::int32_t quantum {4};
+    std::int32_t levels {3};
+    std::int32_t boostInterval {64};
+    std::uint32_t diskPolicy {0};
+    std::int32_t deadline {16};
+    std::uint32_t memory {0};
+    std::int32_t swapDisk {-1};
+    unsigned long long pageSize {4096};
+    unsigned long long swapPages {0};
+    unsigned long long window {64};
+    unsigned long long agingInterval {16};
+    std::uint32_t compaction {0};
+    unsigned long long compactionBudget {1ULL << 20};
+    std::int32_t swapDevice {-1};
+    std::uint32_t swapVictim {0};
+    std::vector<std::uint32_t> perDisk;
+};
+
+inline void putVarint(std::vector<char>& out, unsigned long long value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline void putSigned(std::vector<char>& out, long long value) {
+    putVarint(out, (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));
+}
+
+//returns false if the varint runs past end
+inline bool getVarint(const char*& in, const char* end, unsigned long long& value) {
+    value = 0;
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        auto byte = static_cast<unsigned char>(*in++);
+        value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool getSigned(const char*& in, const char* end, long long& value) {
+    unsigned long long raw = 0;
+    if (!getVarint(in, end, raw)) {
+        return false;
+    }
+    value = static_cast<long long>(raw >> 1) ^ -static_cast<long long>(raw & 1);
+    return true;
+}
+
+//fixed fields go through a same width unsigned integer (doubles included), low byte first on any host
+template <typename T>
+using FixedBits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+template <typename T>
+inline void putFixed(std::vector<char>& out, T value) {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "fixed fields are 32 or 64 bits");
+    FixedBits<T> bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>(bits >> (8 * i)));
+    }
+}
+
+template <typename T>
+inline T getFixed(const char* in) {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "fixed fields are 32 or 64 bits");
+    FixedBits<T> bits = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bits |= static_cast<FixedBits<T>>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
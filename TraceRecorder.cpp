@@ -0,0 +1,214 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include "TraceRecorder.h"
+
+TraceRecorder::TraceRecorder(const std::string& path, int numberOfDisks, unsigned long long amountOfRAM, 
+                             unsigned long long sizeOfOS, const SimOSConfig& config) :
+    sim_{numberOfDisks, amountOfRAM, sizeOfOS, config},
+    file_{std::fopen(path.c_str(), "wb")} {
+
+    buffer_.reserve(FLUSH_BYTES * 2);
+    buffer_.insert(buffer_.end(), TRACE_MAGIC, TRACE_MAGIC + sizeof(TRACE_MAGIC));
+    putFixed<std::uint32_t>(buffer_, TRACE_VERSION);
+    putFixed<std::int32_t>(buffer_, numberOfDisks);
+    putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(config.placement));
+    putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(config.cores));
+    putFixed<unsigned long long>(buffer_, amountOfRAM);
+    putFixed<unsigned long long>(buffer_, sizeOfOS);
+    putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(config.scheduler.type));
+    putFixed<std::int32_t>(buffer_, config.scheduler.quantum);
+    putFixed<std::int32_t>(buffer_, config.scheduler.levels);
+    putFixed<std::int32_t>(buffer_, config.scheduler.boostInterval);
+    putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(config.disks.policy) | (config.disks.merge ? TRACE_DISK_MERGE : 0));
+    putFixed<std::int32_t>(buffer_, config.disks.deadline);
+    putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(config.memory.replacement) | 
+                                       (config.memory.paged ? TRACE_MEMORY_PAGED : 0) | (config.memory.copyOnWrite ? TRACE_MEMORY_COW : 0));
+    putFixed<std::int32_t>(buffer_, config.memory.swapDisk);
+    putFixed<unsigned long long>(buffer_, config.memory.pageSize);
+    putFixed<unsigned long long>(buffer_, config.memory.swapPages);
+    putFixed<unsigned long long>(buffer_, config.memory.window);
+    putFixed<unsigned long long>(buffer_, config.memory.agingInterval);
+    putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(config.compaction.type));
+    putFixed<std::uint32_t>(buffer_, 0);
+    putFixed<unsigned long long>(buffer_, config.compaction.budget);
+    putFixed<std::int32_t>(buffer_, config.swap.disk);
+    putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(config.swap.victim));
+    //policies past the last disk are never used
+    auto policies = std::min(config.disks.perDisk.size(), static_cast<size_t>(std::max(numberOfDisks, 0)));
+    putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(policies));
+    for (size_t disk = 0; disk < policies; ++disk) {
+        putFixed<std::uint32_t>(buffer_, static_cast<std::uint32_t>(config.disks.perDisk[disk]));
+    }
+}
+
+TraceRecorder::~TraceRecorder() {
+    close();
+}
+
+bool TraceRecorder::isOpen() const {
+    return file_ != nullptr;
+}
+
+void TraceRecorder::close() {
+    if (!file_) {
+        return;
+    }
+    op(TraceOp::END);
+    flush();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+SimOS& TraceRecorder::sim() {
+    return sim_;
+}
+
+void TraceRecorder::op(TraceOp code) {
+    if (buffer_.size() >= FLUSH_BYTES) {
+        flush();
+    }
+    buffer_.push_back(static_cast<char>(code));
+}
+
+void TraceRecorder::flush() {
+    if (file_ && !buffer_.empty()) {
+        std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    }
+    buffer_.clear();
+}
+
+int TraceRecorder::fileId(const std::string& fileName) {
+    auto found = fileIds_.find(fileName);
+    if (found != fileIds_.end()) {
+        return found->second;
+    }
+    //first use -> define it in the trace
+    int id = static_cast<int>(fileIds_.size());
+    fileIds_.emplace(fileName, id);
+    op(TraceOp::DEFINE_FILE);
+    putVarint(buffer_, id);
+    putVarint(buffer_, fileName.size());
+    buffer_.insert(buffer_.end(), fileName.begin(), fileName.end());
+    return id;
+}
+
+bool TraceRecorder::NewProcess( unsigned long long size, int priority ) {
+    bool result = sim_.NewProcess(size, priority);
+    op(TraceOp::NEW_PROCESS);
+    putVarint(buffer_, size);
+    putSigned(buffer_, priority);
+    buffer_.push_back(result);
+    return result;
+}
+
+bool TraceRecorder::SimFork() {
+    bool result = sim_.SimFork();
+    op(TraceOp::FORK);
+    buffer_.push_back(result);
+    return result;
+}
+
+void TraceRecorder::SimExit() {
+    sim_.SimExit();
+    op(TraceOp::EXIT);
+}
+
+void TraceRecorder::SimWait() {
+    sim_.SimWait();
+    op(TraceOp::WAIT);
+}
+
+int TraceRecorder::GetCPU() {
+    int result = sim_.GetCPU();
+    op(TraceOp::GET_CPU);
+    putSigned(buffer_, result);
+    return result;
+}
+
+void TraceRecorder::TimerTick() {
+    sim_.TimerTick();
+    op(TraceOp::TIMER_TICK);
+}
+
+bool TraceRecorder::AccessMemory( unsigned long long address ) {
+    bool result = sim_.AccessMemory(address);
+    op(TraceOp::ACCESS_MEMORY);
+    putVarint(buffer_, address);
+    buffer_.push_back(result);
+    return result;
+}
+
+bool TraceRecorder::WriteMemory( unsigned long long address ) {
+    bool result = sim_.WriteMemory(address);
+    op(TraceOp::WRITE_MEMORY);
+    putVarint(buffer_, address);
+    buffer_.push_back(result);
+    return result;
+}
+
+std::vector<int> TraceRecorder::GetReadyQueue() {
+    auto result = sim_.GetReadyQueue();
+    op(TraceOp::GET_READY_QUEUE);
+    putVarint(buffer_, result.size());
+    for (int PID : result) {
+        putSigned(buffer_, PID);
+    }
+    return result;
+}
+
+MemoryUse TraceRecorder::GetMemory() {
+    auto result = sim_.GetMemory();
+    op(TraceOp::GET_MEMORY);
+    putVarint(buffer_, result.size());
+    for (auto& memItem : result) {
+        putVarint(buffer_, memItem.itemAddress);
+        putVarint(buffer_, memItem.itemSize);
+        putSigned(buffer_, memItem.PID);
+    }
+    return result;
+}
+
+void TraceRecorder::DiskReadRequest( int diskNumber, std::string fileName, unsigned long long block, unsigned long long size ) {
+    sim_.DiskReadRequest(diskNumber, fileName, block, size);
+    int id = fileId(fileName);
+    op(TraceOp::DISK_READ);
+    putSigned(buffer_, diskNumber);
+    putVarint(buffer_, id);
+    putVarint(buffer_, block);
+    putVarint(buffer_, size);
+}
+
+void TraceRecorder::DiskJobCompleted( int diskNumber ) {
+    sim_.DiskJobCompleted(diskNumber);
+    op(TraceOp::DISK_COMPLETE);
+    putSigned(buffer_, diskNumber);
+}
+
+FileReadRequest TraceRecorder::GetDisk( int diskNumber ) {
+    auto result = sim_.GetDisk(diskNumber);
+    int id = fileId(result.fileName);
+    op(TraceOp::GET_DISK);
+    putSigned(buffer_, diskNumber);
+    putSigned(buffer_, result.PID);
+    putVarint(buffer_, id);
+    return result;
+}
+
+std::queue<FileReadRequest> TraceRecorder::GetDiskQueue( int diskNumber ) {
+    //intern names first so DEFINE_FILE records don't land inside this record
+    std::vector<int> ids;
+    for (auto& request : sim_.ViewDiskQueue(diskNumber)) {
+        ids.push_back(fileId(request.fileName));
+    }
+    auto result = sim_.GetDiskQueue(diskNumber);
+    op(TraceOp::GET_DISK_QUEUE);
+    putSigned(buffer_, diskNumber);
+    putVarint(buffer_, ids.size());
+    size_t i = 0;
+    for (auto& request : sim_.ViewDiskQueue(diskNumber)) {
+        putSigned(buffer_, request.PID);
+        putVarint(buffer_, ids[i++]);
+    }
+    return result;
+}
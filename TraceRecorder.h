@@ -0,0 +1,51 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SimOS.h"
+#include "TraceFormat.h"
+
+//Drop-in front for SimOS that logs every public call, its arguments and its result
+//Owns the SimOS so the construction parameters end up in the trace header
+class TraceRecorder {
+    public:
+        TraceRecorder(const std::string& path, int numberOfDisks, unsigned long long amountOfRAM, 
+                      unsigned long long sizeOfOS, const SimOSConfig& config = SimOSConfig{});
+        ~TraceRecorder();
+        TraceRecorder(const TraceRecorder&) = delete;
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+        bool isOpen() const;
+        //write END and close, called by the destructor if needed
+        void close();
+        SimOS& sim();
+
+        bool NewProcess( unsigned long long size, int priority );
+        bool SimFork();
+        void SimExit();
+        void SimWait();
+        int GetCPU();
+        void TimerTick();
+        bool AccessMemory( unsigned long long address );
+        bool WriteMemory( unsigned long long address );
+        std::vector<int> GetReadyQueue();
+        MemoryUse GetMemory();
+        void DiskReadRequest( int diskNumber, std::string fileName, unsigned long long block = 0, unsigned long long size = 0 );
+        void DiskJobCompleted( int diskNumber );
+        FileReadRequest GetDisk( int diskNumber );
+        std::queue<FileReadRequest> GetDiskQueue( int diskNumber );
+
+    private:
+        static constexpr size_t FLUSH_BYTES {1 << 16};
+        SimOS sim_;
+        std::FILE* file_;
+        std::vector<char> buffer_;
+        std::unordered_map<std::string, int> fileIds_;
+
+        void op(TraceOp code);
+        int fileId(const std::string& fileName);
+        void flush();
+};
@@ -0,0 +1,348 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "TraceReplayer.h"
+
+TraceReplayer::TraceReplayer(const std::string& path) :
+    data_{nullptr},
+    size_{0},
+    headerSize_{0},
+    valid_{false} {
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= TRACE_HEADER_SIZE_V1) {
+        void* mapping = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            data_ = static_cast<const char*>(mapping);
+            size_ = info.st_size;
+            ::madvise(mapping, size_, MADV_SEQUENTIAL);
+        }
+    }
+    ::close(fd);
+    if (!data_ || std::memcmp(data_, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        return;
+    }
+
+    header_.version = getFixed<std::uint32_t>(data_ + 8);
+    header_.numberOfDisks = getFixed<std::int32_t>(data_ + 12);
+    header_.placement = getFixed<std::uint32_t>(data_ + 16);
+    header_.cores = std::max<std::uint32_t>(1, getFixed<std::uint32_t>(data_ + 20));
+    header_.amountOfRAM = getFixed<unsigned long long>(data_ + 24);
+    header_.sizeOfOS = getFixed<unsigned long long>(data_ + 32);
+    if ((header_.version == TRACE_VERSION && size_ >= TRACE_HEADER_SIZE) || 
+        (header_.version == 6 && size_ >= TRACE_HEADER_SIZE_V6) ||
+        (header_.version == 5 && size_ >= TRACE_HEADER_SIZE_V5) ||
+        (header_.version == 4 && size_ >= TRACE_HEADER_SIZE_V4) ||
+        (header_.version == 3 && size_ >= TRACE_HEADER_SIZE_V3) ||
+        (header_.version == 2 && size_ >= TRACE_HEADER_SIZE_V2)) {
+        header_.scheduler = getFixed<std::uint32_t>(data_ + 40);
+        header_.quantum = getFixed<std::int32_t>(data_ + 44);
+        header_.levels = getFixed<std::int32_t>(data_ + 48);
+        header_.boostInterval = getFixed<std::int32_t>(data_ + 52);
+        headerSize_ = TRACE_HEADER_SIZE_V2;
+        if (header_.version >= 3) {
+            header_.diskPolicy = getFixed<std::uint32_t>(data_ + 56);
+            header_.deadline = getFixed<std::int32_t>(data_ + 60);
+            headerSize_ = TRACE_HEADER_SIZE_V3;
+        }
+        if (header_.version >= 4) {
+            header_.memory = getFixed<std::uint32_t>(data_ + 64);
+            header_.swapDisk = getFixed<std::int32_t>(data_ + 68);
+            header_.pageSize = getFixed<unsigned long long>(data_ + 72);
+            header_.swapPages = getFixed<unsigned long long>(data_ + 80);
+            header_.window = getFixed<unsigned long long>(data_ + 88);
+            header_.agingInterval = getFixed<unsigned long long>(data_ + 96);
+            headerSize_ = TRACE_HEADER_SIZE_V4;
+        }
+        if (header_.version >= 5) {
+            header_.compaction = getFixed<std::uint32_t>(data_ + 104);
+            header_.compactionBudget = getFixed<unsigned long long>(data_ + 112);
+            headerSize_ = TRACE_HEADER_SIZE_V5;
+        }
+        if (header_.version >= 6) {
+            header_.swapDevice = getFixed<std::int32_t>(data_ + 120);
+            header_.swapVictim = getFixed<std::uint32_t>(data_ + 124);
+            headerSize_ = TRACE_HEADER_SIZE_V6;
+        }
+        if (header_.version == TRACE_VERSION) {
+            //no more policies than disks, all of them inside the file
+            auto count = getFixed<std::uint32_t>(data_ + 128);
+            headerSize_ = TRACE_HEADER_SIZE;
+            if (count > static_cast<std::uint32_t>(std::max(header_.numberOfDisks, 0)) ||
+                size_ - headerSize_ < static_cast<size_t>(count) * 4) {
+                return;
+            }
+            for (std::uint32_t disk = 0; disk < count; ++disk, headerSize_ += 4) {
+                header_.perDisk.push_back(getFixed<std::uint32_t>(data_ + headerSize_));
+            }
+        }
+        valid_ = true;
+    } else if (header_.version == 1) {
+        headerSize_ = TRACE_HEADER_SIZE_V1;
+        valid_ = true;
+    }
+}
+
+TraceReplayer::~TraceReplayer() {
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+bool TraceReplayer::valid() const {
+    return valid_;
+}
+
+const TraceHeader& TraceReplayer::header() const {
+    return header_;
+}
+
+size_t TraceReplayer::bytes() const {
+    return size_;
+}
+
+ReplayStats TraceReplayer::replay() const {
+    if (!valid_) {
+        return ReplayStats{};
+    }
+    SimOSConfig config;
+    config.placement = static_cast<PlacementType>(header_.placement);
+    config.cores = static_cast<int>(header_.cores);
+    config.scheduler.type = static_cast<SchedulerType>(header_.scheduler);
+    config.scheduler.quantum = header_.quantum;
+    config.scheduler.levels = header_.levels;
+    config.scheduler.boostInterval = header_.boostInterval;
+    config.disks.policy = static_cast<DiskPolicyType>(header_.diskPolicy & ~TRACE_DISK_MERGE);
+    config.disks.merge = (header_.diskPolicy & TRACE_DISK_MERGE) != 0;
+    config.disks.deadline = header_.deadline;
+    for (auto policy : header_.perDisk) {
+        config.disks.perDisk.push_back(static_cast<DiskPolicyType>(policy));
+    }
+    config.memory.paged = (header_.memory & TRACE_MEMORY_PAGED) != 0;
+    config.memory.copyOnWrite = (header_.memory & TRACE_MEMORY_COW) != 0;
+    config.memory.replacement = static_cast<ReplacementType>(header_.memory & ~(TRACE_MEMORY_PAGED | TRACE_MEMORY_COW));
+    config.memory.swapDisk = header_.swapDisk;
+    config.memory.pageSize = header_.pageSize;
+    config.memory.swapPages = header_.swapPages;
+    config.memory.window = header_.window;
+    config.memory.agingInterval = header_.agingInterval;
+    config.compaction.type = static_cast<CompactionType>(header_.compaction);
+    config.compaction.budget = header_.compactionBudget;
+    config.swap.disk = header_.swapDevice;
+    config.swap.victim = static_cast<SwapVictimType>(header_.swapVictim);
+    SimOS sim (header_.numberOfDisks, header_.amountOfRAM, header_.sizeOfOS, config);
+    return replay(sim, true);
+}
+
+ReplayStats TraceReplayer::replay(SimOS& sim, bool verify) const {
+    ReplayStats stats;
+    if (!valid_) {
+        return stats;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::string> fileNames;
+    std::vector<SimCommand> commands;
+    std::vector<SimResult> expected;
+    std::vector<SimResult> results (BATCH_SIZE);
+    commands.reserve(BATCH_SIZE);
+    expected.reserve(BATCH_SIZE);
+
+    auto mismatch = [&stats](size_t call) {
+        if (stats.mismatches++ == 0) {
+            stats.firstMismatch = call;
+        }
+    };
+    //apply the pending run of mutating calls
+    auto flush = [&]() {
+        if (commands.empty()) {
+            return;
+        }
+        sim.ApplyBatch(commands.data(), commands.size(), results.data(), fileNames);
+        size_t firstCall = stats.calls - commands.size();
+        for (size_t i = 0; i < commands.size(); ++i) {
+            if (commands[i].type == CommandType::NEW_PROCESS) {
+                ++(results[i] ? stats.admitted : stats.rejected);
+            } else if (commands[i].type == CommandType::FORK) {
+                ++(results[i] ? stats.forks : stats.failedForks);
+            }
+            if (verify && results[i] != expected[i]) {
+                mismatch(firstCall + i);
+            }
+        }
+        commands.clear();
+        expected.clear();
+    };
+    auto queue = [&](SimCommand command, SimResult result) {
+        commands.push_back(command);
+        expected.push_back(result);
+        ++stats.calls;
+        if (commands.size() == BATCH_SIZE) {
+            flush();
+        }
+    };
+
+    const char* in = data_ + headerSize_;
+    const char* end = data_ + size_;
+    bool ok = true;
+    while (ok && in < end) {
+        auto code = static_cast<TraceOp>(static_cast<unsigned char>(*in++));
+        unsigned long long u = 0, count = 0;
+        long long a = 0, b = 0;
+        switch (code) {
+            case TraceOp::NEW_PROCESS:
+                ok = getVarint(in, end, u) && getSigned(in, end, a) && in < end;
+                if (ok) {
+                    queue({u, static_cast<int>(a), 0, CommandType::NEW_PROCESS}, *in++);
+                }
+                break;
+            case TraceOp::FORK:
+                ok = in < end;
+                if (ok) {
+                    queue({0, 0, 0, CommandType::FORK}, *in++);
+                }
+                break;
+            case TraceOp::EXIT:
+                queue({0, 0, 0, CommandType::EXIT}, 0);
+                break;
+            case TraceOp::WAIT:
+                queue({0, 0, 0, CommandType::WAIT}, 0);
+                break;
+            case TraceOp::DISK_READ: {
+                unsigned long long block = 0, size = 0;
+                ok = getSigned(in, end, a) && getVarint(in, end, u) && 
+                     (header_.version < 3 || (getVarint(in, end, block) && getVarint(in, end, size)));
+                if (ok) {
+                    queue({size, static_cast<int>(a), static_cast<int>(u), CommandType::DISK_READ, 0, block}, 0);
+                }
+                break;
+            }
+            case TraceOp::DISK_COMPLETE:
+                ok = getSigned(in, end, a);
+                if (ok) {
+                    queue({0, static_cast<int>(a), 0, CommandType::DISK_COMPLETE}, 0);
+                }
+                break;
+            case TraceOp::GET_CPU:
+                ok = getSigned(in, end, a);
+                if (ok) {
+                    queue({0, 0, 0, CommandType::GET_CPU}, static_cast<int>(a));
+                }
+                break;
+            case TraceOp::TIMER_TICK:
+                queue({0, 0, 0, CommandType::TIMER_TICK}, 0);
+                break;
+            case TraceOp::ACCESS_MEMORY:
+                ok = getVarint(in, end, u) && in < end;
+                if (ok) {
+                    queue({u, 0, 0, CommandType::ACCESS_MEMORY}, *in++);
+                }
+                break;
+            case TraceOp::WRITE_MEMORY:
+                ok = getVarint(in, end, u) && in < end;
+                if (ok) {
+                    queue({u, 0, 0, CommandType::WRITE_MEMORY}, *in++);
+                }
+                break;
+            case TraceOp::GET_READY_QUEUE: {
+                flush();
+                ok = getVarint(in, end, count);
+                auto view = sim.ViewReadyQueue();
+                bool same = view.size() == count;
+                auto live = view.begin();
+                for (unsigned long long i = 0; ok && i < count; ++i) {
+                    ok = getSigned(in, end, a);
+                    if (same) {
+                        same = *live == a;
+                        ++live;
+                    }
+                }
+                if (verify && !same) {
+                    mismatch(stats.calls);
+                }
+                ++stats.calls;
+                break;
+            }
+            case TraceOp::GET_MEMORY: {
+                flush();
+                ok = getVarint(in, end, count);
+                auto view = sim.ViewMemory();
+                bool same = view.size() == count;
+                auto live = view.begin();
+                for (unsigned long long i = 0; ok && i < count; ++i) {
+                    unsigned long long address = 0, size = 0;
+                    ok = getVarint(in, end, address) && getVarint(in, end, size) && getSigned(in, end, a);
+                    if (same) {
+                        same = (*live).itemAddress == address && (*live).itemSize == size && (*live).PID == a;
+                        ++live;
+                    }
+                }
+                if (verify && !same) {
+                    mismatch(stats.calls);
+                }
+                ++stats.calls;
+                break;
+            }
+            case TraceOp::GET_DISK: {
+                flush();
+                ok = getSigned(in, end, a) && getSigned(in, end, b) && getVarint(in, end, u) && u < fileNames.size();
+                if (ok) {
+                    auto live = sim.GetDisk(static_cast<int>(a));
+                    if (verify && (live.PID != b || live.fileName != fileNames[u])) {
+                        mismatch(stats.calls);
+                    }
+                }
+                ++stats.calls;
+                break;
+            }
+            case TraceOp::GET_DISK_QUEUE: {
+                flush();
+                ok = getSigned(in, end, a) && getVarint(in, end, count);
+                auto view = sim.ViewDiskQueue(static_cast<int>(a));
+                bool same = view.size() == count;
+                auto live = view.begin();
+                for (unsigned long long i = 0; ok && i < count; ++i) {
+                    ok = getSigned(in, end, b) && getVarint(in, end, u) && u < fileNames.size();
+                    if (ok && same) {
+                        same = (*live).PID == b && (*live).fileName == fileNames[u];
+                        ++live;
+                    }
+                }
+                if (verify && !same) {
+                    mismatch(stats.calls);
+                }
+                ++stats.calls;
+                break;
+            }
+            case TraceOp::DEFINE_FILE:
+                ok = getVarint(in, end, u) && getVarint(in, end, count) && u == fileNames.size() 
+                    && count <= static_cast<unsigned long long>(end - in);
+                if (ok) {
+                    fileNames.emplace_back(in, count);
+                    in += count;
+                }
+                break;
+            case TraceOp::END:
+                flush();
+                stats.complete = true;
+                in = end;
+                break;
+            default:
+                ok = false;
+                break;
+        }
+    }
+    flush();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
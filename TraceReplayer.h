@@ -0,0 +1,48 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <string>
+#include <vector>
+#include "SimOS.h"
+#include "TraceFormat.h"
+
+struct ReplayStats {
+    bool complete {false};          //reached END without a decode error
+    size_t calls {0};               //public calls replayed
+    size_t mismatches {0};          //results that differ from the recording
+    size_t firstMismatch {0};       //call index of the first mismatch
+    size_t admitted {0};            //NewProcess results of the replayed SimOS (not the recording)
+    size_t rejected {0};
+    size_t forks {0};
+    size_t failedForks {0};
+    double seconds {0};
+};
+
+//Memory maps a trace and drives a SimOS with it
+//Mutating calls are decoded into SimCommand runs and applied with ApplyBatch,
+//getters flush the run and are checked against live views (no copies)
+//replay() never touches the mapping -> one replayer can feed many threads
+class TraceReplayer {
+    public:
+        explicit TraceReplayer(const std::string& path);
+        ~TraceReplayer();
+        TraceReplayer(const TraceReplayer&) = delete;
+        TraceReplayer& operator=(const TraceReplayer&) = delete;
+
+        bool valid() const;
+        const TraceHeader& header() const;
+        size_t bytes() const;
+
+        //fresh SimOS built from the header, results checked against the recording
+        ReplayStats replay() const;
+        //caller's SimOS (other config), verify=false only replays the calls
+        ReplayStats replay(SimOS& sim, bool verify) const;
+
+    private:
+        static constexpr size_t BATCH_SIZE {4096};
+        const char* data_;
+        size_t size_;
+        TraceHeader header_;
+        size_t headerSize_;
+        bool valid_;
+};
@@ -0,0 +1,44 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+//Non-owning range over a live SimOS structure
+//Project turns each underlying element into what the caller sees (PID, MemoryItem, ...)
+//Any call that changes SimOS state invalidates the view
+template <typename Iterator, typename Project>
+class View {
+    public:
+        class iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = std::decay_t<decltype(Project{}(*std::declval<Iterator>()))>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const value_type*;
+                using reference = decltype(Project{}(*std::declval<Iterator>()));
+
+                iterator() = default;
+                explicit iterator(Iterator it) : it_{it} {}
+                reference operator*() const { return Project{}(*it_); }
+                iterator& operator++() { ++it_; return *this; }
+                iterator operator++(int) { iterator old = *this; ++it_; return old; }
+                bool operator==(const iterator& other) const { return it_ == other.it_; }
+                bool operator!=(const iterator& other) const { return it_ != other.it_; }
+            private:
+                Iterator it_;
+        };
+
+        View(Iterator first, Iterator last, size_t size) : first_{first}, last_{last}, size_{size} {}
+        iterator begin() const { return iterator(first_); }
+        iterator end() const { return iterator(last_); }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+    private:
+        Iterator first_;
+        Iterator last_;
+        size_t size_;
+};
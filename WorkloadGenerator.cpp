@@ -0,0 +1,238 @@
+//Jacky Qiu
+//----------------------------------
+#include <algorithm>
+#include "WorkloadGenerator.h"
+
+WorkloadConfig fragmentationWorkload(std::uint64_t seed, size_t operations) {
+    WorkloadConfig config;
+    config.seed = seed;
+    config.operations = operations;
+    config.amountOfRAM = 1ULL << 24;
+    config.sizeOfOS = 1ULL << 12;
+    config.sizeDistribution = SizeDistribution::LOG_UNIFORM;
+    config.minSize = 16;
+    config.maxSize = 1ULL << 20;
+    config.newProcessWeight = 6;
+    config.forkWeight = 0;
+    config.exitWeight = 5;
+    config.waitWeight = 0;
+    config.diskReadWeight = 1;
+    config.diskCompleteWeight = 1;
+    return config;
+}
+
+WorkloadConfig forkBombWorkload(std::uint64_t seed, size_t operations) {
+    WorkloadConfig config;
+    config.seed = seed;
+    config.operations = operations;
+    config.amountOfRAM = 1ULL << 40;
+    config.sizeOfOS = 1ULL << 12;
+    config.minSize = 1;
+    config.maxSize = 64;
+    config.newProcessWeight = 1;
+    config.forkWeight = 20;
+    config.exitWeight = 0.5;
+    config.waitWeight = 2;
+    config.diskReadWeight = 3;
+    config.diskCompleteWeight = 3;
+    config.maxFanOut = 16;
+    config.maxDepth = 64;
+    return config;
+}
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig& config) :
+    config_{config},
+    random_{config.seed},
+    nextPID_{2},
+    lastCPU_{NO_PROCESS} {
+
+    for (int i = 0; i < config_.fileCount; ++i) {
+        fileNames_.push_back("file" + std::to_string(i));
+    }
+    if (fileNames_.empty()) {
+        fileNames_.push_back("file0");
+    }
+    //disk picked by binary search over cumulative shares
+    double total = 0;
+    for (int disk = 0; disk < config_.numberOfDisks; ++disk) {
+        bool uniform = config_.diskShare.size() != static_cast<size_t>(config_.numberOfDisks);
+        total += uniform ? 1.0 : config_.diskShare[disk];
+        diskCumulative_.push_back(total);
+    }
+}
+
+const std::vector<std::string>& WorkloadGenerator::fileNames() const {
+    return fileNames_;
+}
+
+const WorkloadConfig& WorkloadGenerator::config() const {
+    return config_;
+}
+
+const WorkloadStats& WorkloadGenerator::stats() const {
+    return stats_;
+}
+
+unsigned long long WorkloadGenerator::drawSize() {
+    unsigned long long low = std::max(1ULL, config_.minSize);
+    unsigned long long high = std::max(low, config_.maxSize);
+    if (config_.sizeDistribution == SizeDistribution::UNIFORM) {
+        return random_.uniform(low, high);
+    }
+    //pick a bit width, then a size inside that power of two bucket
+    int lowBits = 64 - __builtin_clzll(low);
+    int highBits = 64 - __builtin_clzll(high);
+    int bits = static_cast<int>(random_.uniform(lowBits, highBits));
+    unsigned long long bucketLow = std::max(low, 1ULL << (bits - 1));
+    unsigned long long bucketHigh = bits == 64 ? high : std::min(high, (1ULL << bits) - 1);
+    return random_.uniform(bucketLow, bucketHigh);
+}
+
+int WorkloadGenerator::drawDisk() {
+    double pick = random_.unit() * diskCumulative_.back();
+    auto found = std::upper_bound(diskCumulative_.begin(), diskCumulative_.end(), pick);
+    if (found == diskCumulative_.end()) {
+        --found;
+    }
+    return static_cast<int>(found - diskCumulative_.begin());
+}
+
+void WorkloadGenerator::track(int PID, std::uint16_t depth, unsigned long long size) {
+    if (PID >= static_cast<int>(depth_.size())) {
+        depth_.resize(PID + 1, 0);
+        fanOut_.resize(PID + 1, 0);
+        sizes_.resize(PID + 1, 0);
+    }
+    depth_[PID] = depth;
+    fanOut_[PID] = 0;
+    sizes_[PID] = size;
+}
+
+SimCommand WorkloadGenerator::next(SimOS& sim) {
+    int cpu = sim.GetCPU();
+    lastCPU_ = cpu;
+    bool userRunning = cpu > 1 && cpu < static_cast<int>(depth_.size());
+
+    busyDisks_.clear();
+    for (int disk = 0; disk < config_.numberOfDisks; ++disk) {
+        if (sim.GetDisk(disk).PID != 0) {
+            busyDisks_.push_back(disk);
+        }
+    }
+
+    //only calls that can do something right now compete
+    bool canFork = userRunning && fanOut_[cpu] < config_.maxFanOut && depth_[cpu] < config_.maxDepth;
+    bool canWait = userRunning && fanOut_[cpu] > 0;
+    bool canRead = userRunning && config_.numberOfDisks > 0;
+    bool canAccess = userRunning && sizes_[cpu] > 0;
+    double weights[] = {
+        config_.newProcessWeight,
+        canFork ? config_.forkWeight : 0,
+        userRunning ? config_.exitWeight : 0,
+        canWait ? config_.waitWeight : 0,
+        canRead ? config_.diskReadWeight : 0,
+        busyDisks_.empty() ? 0 : config_.diskCompleteWeight,
+        canAccess ? config_.accessWeight : 0,
+        canAccess ? config_.writeWeight : 0
+    };
+    double total = 0;
+    int lastPossible = 0;
+    for (int i = 0; i < 8; ++i) {
+        total += weights[i];
+        lastPossible = weights[i] > 0 ? i : lastPossible;
+    }
+    int choice = 0;
+    if (total > 0) {
+        double pick = random_.unit() * total;
+        while (choice < 7 && (pick -= weights[choice]) >= 0) {
+            ++choice;
+        }
+        if (weights[choice] == 0) {     //rounding landed on a skipped call
+            choice = lastPossible;
+        }
+    }
+
+    SimCommand command;
+    switch (choice) {
+        case 0:
+            command.type = CommandType::NEW_PROCESS;
+            command.size = drawSize();
+            command.arg = static_cast<int>(random_.uniform(config_.minPriority, std::max(config_.minPriority, config_.maxPriority)));
+            break;
+        case 1:
+            command.type = CommandType::FORK;
+            break;
+        case 2:
+            command.type = CommandType::EXIT;
+            break;
+        case 3:
+            command.type = CommandType::WAIT;
+            break;
+        case 4:
+            command.type = CommandType::DISK_READ;
+            command.arg = drawDisk();
+            command.fileId = static_cast<int>(random_.uniform(0, fileNames_.size() - 1));
+            if (config_.diskBlocks > 0) {
+                command.block = random_.uniform(0, config_.diskBlocks - 1);
+                command.size = random_.uniform(1, std::max(1ULL, config_.maxReadBlocks));
+            }
+            break;
+        case 5:
+            command.type = CommandType::DISK_COMPLETE;
+            command.arg = busyDisks_[random_.uniform(0, busyDisks_.size() - 1)];
+            break;
+        case 6:
+            command.type = CommandType::ACCESS_MEMORY;
+            command.size = random_.uniform(0, sizes_[cpu] - 1);
+            break;
+        default:
+            command.type = CommandType::WRITE_MEMORY;
+            command.size = random_.uniform(0, sizes_[cpu] - 1);
+            break;
+    }
+    return command;
+}
+
+void WorkloadGenerator::observe(const SimCommand& command, SimResult result) {
+    ++stats_.calls;
+    switch (command.type) {
+        case CommandType::NEW_PROCESS:
+            if (result) {
+                ++stats_.admitted;
+                track(nextPID_++, 0, command.size);
+            } else {
+                ++stats_.rejected;
+            }
+            break;
+        case CommandType::FORK:
+            if (result) {
+                ++stats_.forks;
+                ++fanOut_[lastCPU_];
+                track(nextPID_++, depth_[lastCPU_] + 1, sizes_[lastCPU_]);
+            } else {
+                ++stats_.failedForks;
+            }
+            break;
+        case CommandType::EXIT:
+            ++stats_.exits;
+            break;
+        case CommandType::WAIT:
+            ++stats_.waits;
+            break;
+        case CommandType::DISK_READ:
+            ++stats_.diskReads;
+            break;
+        case CommandType::DISK_COMPLETE:
+            ++stats_.diskCompletions;
+            break;
+        case CommandType::ACCESS_MEMORY:
+            ++stats_.accesses;
+            break;
+        case CommandType::WRITE_MEMORY:
+            ++stats_.writes;
+            break;
+        case CommandType::GET_CPU:
+        case CommandType::TIMER_TICK:
+            break;
+    }
+}
@@ -0,0 +1,164 @@
+//Jacky Qiu
+//----------------------------------
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Random.h"
+#include "SimOS.h"
+#include "SimCommand.h"
+#include "TraceRecorder.h"
+
+enum class SizeDistribution {
+    UNIFORM,            //every size in [minSize, maxSize] equally likely
+    LOG_UNIFORM         //every power of two bucket equally likely, many small and a few huge
+};
+
+//Everything a workload depends on, same seed + same config -> same call sequence
+//(draws read the simulator's state, so this holds because SimOS is deterministic: ties run in enqueue order)
+struct WorkloadConfig {
+    std::uint64_t seed{1};
+    size_t operations{10000};
+
+    //machine the workload is meant for
+    int numberOfDisks{2};
+    unsigned long long amountOfRAM{1'000'000};
+    unsigned long long sizeOfOS{1000};
+    SimOSConfig sim{};
+
+    //new processes
+    SizeDistribution sizeDistribution{SizeDistribution::UNIFORM};
+    unsigned long long minSize{1};
+    unsigned long long maxSize{10000};
+    int minPriority{1};
+    int maxPriority{10};
+
+    //relative weight of each call, calls that can't happen right now are skipped
+    double newProcessWeight{4};
+    double forkWeight{2};
+    double exitWeight{2};
+    double waitWeight{1};
+    double diskReadWeight{2};
+    double diskCompleteWeight{2};
+    double accessWeight{0};             //AccessMemory at a uniform address of the running process
+    double writeWeight{0};              //WriteMemory, same
+
+    //fork limits, fan-out counts every child a process ever forked
+    int maxFanOut{4};
+    int maxDepth{8};
+
+    //relative share of reads per disk, empty means uniform
+    std::vector<double> diskShare;
+    int fileCount{16};
+    //reads land on a uniform block below this (0 = no block addresses), size in [1, maxReadBlocks]
+    unsigned long long diskBlocks{0};
+    unsigned long long maxReadBlocks{8};
+};
+
+//Ready made scenarios
+WorkloadConfig fragmentationWorkload(std::uint64_t seed, size_t operations);     //mixed sizes, admit/exit churn in tight RAM
+WorkloadConfig forkBombWorkload(std::uint64_t seed, size_t operations);          //deep & wide fork trees, rare exits
+
+struct WorkloadStats {
+    size_t calls{0};
+    size_t admitted{0};
+    size_t rejected{0};
+    size_t forks{0};
+    size_t failedForks{0};
+    size_t exits{0};
+    size_t waits{0};
+    size_t diskReads{0};
+    size_t diskCompletions{0};
+    size_t accesses{0};
+    size_t writes{0};
+};
+
+//Seeded stream of SimOS calls
+//Each call is drawn against the live state of the simulator (who is running, which disks are busy)
+//so the stream stays meaningful instead of mostly hitting guard clauses
+class WorkloadGenerator {
+    public:
+        explicit WorkloadGenerator(const WorkloadConfig& config);
+
+        //draw the next call for the current state of sim, then report its result with observe
+        SimCommand next(SimOS& sim);
+        void observe(const SimCommand& command, SimResult result);
+
+        //file name table for DISK_READ commands (SimCommand::fileId)
+        const std::vector<std::string>& fileNames() const;
+        const WorkloadConfig& config() const;
+        const WorkloadStats& stats() const;
+
+        //stream config.operations calls into a SimOS or a TraceRecorder
+        //the target should be built from config.numberOfDisks / amountOfRAM / sizeOfOS / sim
+        template <typename Target>
+        WorkloadStats run(Target& target);
+
+    private:
+        WorkloadConfig config_;
+        std::vector<std::string> fileNames_;
+        std::vector<double> diskCumulative_;
+        WorkloadStats stats_;
+        Random random_;
+        int nextPID_;                           //PID the next admitted/forked process will get
+        int lastCPU_;                           //PID running when the last command was drawn
+        std::vector<std::uint16_t> depth_;      //by PID
+        std::vector<std::uint16_t> fanOut_;     //by PID
+        std::vector<unsigned long long> sizes_; //by PID
+        std::vector<int> busyDisks_;            //reused by next
+
+        unsigned long long drawSize();
+        int drawDisk();
+        void track(int PID, std::uint16_t depth, unsigned long long size);
+};
+
+inline SimOS& simOf(SimOS& sim) {
+    return sim;
+}
+
+inline SimOS& simOf(TraceRecorder& recorder) {
+    return recorder.sim();
+}
+
+template <typename Target>
+SimResult applyCommand(Target& target, const SimCommand& command, const std::vector<std::string>& fileNames) {
+    switch (command.type) {
+        case CommandType::NEW_PROCESS:
+            return target.NewProcess(command.size, command.arg);
+        case CommandType::FORK:
+            return target.SimFork();
+        case CommandType::EXIT:
+            target.SimExit();
+            return 0;
+        case CommandType::WAIT:
+            target.SimWait();
+            return 0;
+        case CommandType::DISK_READ:
+            target.DiskReadRequest(command.arg, fileNames[command.fileId], command.block, command.size);
+            return 0;
+        case CommandType::DISK_COMPLETE:
+            target.DiskJobCompleted(command.arg);
+            return 0;
+        case CommandType::GET_CPU:
+            return target.GetCPU();
+        case CommandType::TIMER_TICK:
+            target.TimerTick();
+            return 0;
+        case CommandType::ACCESS_MEMORY:
+            return target.AccessMemory(command.size);
+        case CommandType::WRITE_MEMORY:
+            return target.WriteMemory(command.size);
+    }
+    return 0;
+}
+
+template <typename Target>
+WorkloadStats WorkloadGenerator::run(Target& target) {
+    //state queries go to the SimOS underneath so a recorder only logs the workload itself
+    SimOS& sim = simOf(target);
+    for (size_t i = 0; i < config_.operations; ++i) {
+        SimCommand command = next(sim);
+        observe(command, applyCommand(target, command, fileNames_));
+    }
+    return stats_;
+}